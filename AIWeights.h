@@ -0,0 +1,70 @@
+#pragma once
+#include <string>
+#include <fstream>
+#include <iostream>
+
+// The heuristic AI's scoring weights. WeightTuner searches for better ones by
+// self-play and writes them in the text format save()/load() use: one
+// "name value" line per weight. The defaults come from
+// `tune --iterations 300 --games 4000 --seed 11`, which scored 51.4% against
+// the original hand-picked { -2, 50, -30, -3, -40, 30, -25, -1, -100, 20 };
+// attack_unanswerable came later and was set by a sweep over 200k games.
+struct AIWeights {
+    enum Weight {
+        ATTACK_VALUE = 0,               // per point of card value
+        ATTACK_NON_TRUMP = 1,
+        ATTACK_TRUMP = 2,
+        DEFENSE_VALUE = 3,              // per point of card value
+        DEFENSE_TRUMP_WITH_ALTERNATIVE = 4,
+        DEFENSE_TRUMP_FORCED = 5,
+        DEFENSE_HIGH_CARD = 6,          // cards worth more than a ten
+        STRATEGIC_VALUE = 7,            // per point of card value
+        STRATEGIC_TRUMP_WITH_ALTERNATIVE = 8,
+        STRATEGIC_SAME_SUIT = 9,
+        ATTACK_UNANSWERABLE = 10,       // nothing the defender may hold beats it
+        COUNT = 11
+    };
+
+    int values[COUNT] = { -1, 58, -25, -2, -55, 33, -19, 0, -105, 21, 20 };
+
+    int operator[](Weight weight) const { return values[weight]; }
+    int& operator[](Weight weight) { return values[weight]; }
+
+    static const char* name(int weight) {
+        static const char* const NAMES[COUNT] = {
+            "attack_value", "attack_non_trump", "attack_trump",
+            "defense_value", "defense_trump_with_alternative", "defense_trump_forced", "defense_high_card",
+            "strategic_value", "strategic_trump_with_alternative", "strategic_same_suit",
+            "attack_unanswerable"
+        };
+        return NAMES[weight];
+    }
+
+    bool save(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file) return false;
+        for (int i = 0; i < COUNT; ++i) {
+            file << name(i) << " " << values[i] << "\n";
+        }
+        return static_cast<bool>(file);
+    }
+
+    // Unknown names are reported and skipped; missing ones keep their value.
+    bool load(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) return false;
+
+        std::string key;
+        int value;
+        while (file >> key >> value) {
+            int i = 0;
+            while (i < COUNT && key != name(i)) ++i;
+            if (i == COUNT) {
+                std::cout << "Unknown AI weight: " << key << std::endl;
+                continue;
+            }
+            values[i] = value;
+        }
+        return file.eof();
+    }
+};
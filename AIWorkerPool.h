@@ -0,0 +1,182 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include "Profiler.h"
+
+// Long-lived AI worker threads with one task deque per worker. A worker pops
+// from the back of its own deque and steals from the front of the others when
+// it runs dry. The thread waiting on a TaskGroup also runs queued tasks, so a
+// decision never blocks on a sleeping worker.
+class AIWorkerPool {
+public:
+    typedef void (*TaskFunction)(void* context);
+
+    struct TaskGroup {
+        std::atomic<int> pending{ 0 };
+    };
+
+    explicit AIWorkerPool(int numThreads) : queues(std::max(1, numThreads)), queuedTasks(0), stopping(false) {
+        for (int i = 0; i < static_cast<int>(queues.size()); ++i) {
+            queues[i].reset(new TaskQueue());
+        }
+        for (int i = 0; i < static_cast<int>(queues.size()); ++i) {
+            workers.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    ~AIWorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    AIWorkerPool(const AIWorkerPool&) = delete;
+    AIWorkerPool& operator=(const AIWorkerPool&) = delete;
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+    // Nanoseconds the workers have spent running tasks; only counted when
+    // profiling. Sampled twice, it gives the pool's utilization in between.
+    uint64_t getBusyTime() const { return busyTime.load(std::memory_order_relaxed); }
+
+    void submit(TaskGroup& group, TaskFunction function, void* context) {
+        group.pending.fetch_add(1, std::memory_order_relaxed);
+        Task task = { function, context, &group };
+
+        int queueIndex = static_cast<int>(nextQueue.fetch_add(1, std::memory_order_relaxed) % static_cast<unsigned>(queues.size()));
+        if (!queues[queueIndex]->pushBack(task)) {
+            runTask(task);
+            return;
+        }
+
+        queuedTasks.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        wakeUp.notify_one();
+    }
+
+    void wait(TaskGroup& group) {
+        while (group.pending.load(std::memory_order_acquire) > 0) {
+            Task task;
+            if (stealAny(0, task)) {
+                runTask(task);
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    struct Task {
+        TaskFunction function;
+        void* context;
+        TaskGroup* group;
+    };
+
+    class TaskQueue {
+    public:
+        bool pushBack(const Task& task) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (count == CAPACITY) return false;
+            tasks[(head + count) % CAPACITY] = task;
+            ++count;
+            return true;
+        }
+
+        bool popBack(Task& task) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (count == 0) return false;
+            --count;
+            task = tasks[(head + count) % CAPACITY];
+            return true;
+        }
+
+        bool stealFront(Task& task) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (count == 0) return false;
+            task = tasks[head];
+            head = (head + 1) % CAPACITY;
+            --count;
+            return true;
+        }
+
+    private:
+        static constexpr int CAPACITY = 256;
+        std::mutex mutex;
+        Task tasks[CAPACITY];
+        int head = 0;
+        int count = 0;
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<unsigned> nextQueue{ 0 };  // wraps harmlessly
+    std::atomic<int> queuedTasks;
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    bool stopping;
+    std::atomic<uint64_t> busyTime{ 0 };
+
+    void runTask(const Task& task) {
+        task.function(task.context);
+        task.group->pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    bool stealAny(int firstQueue, Task& task) {
+        int numQueues = static_cast<int>(queues.size());
+        for (int i = 0; i < numQueues; ++i) {
+            if (queues[(firstQueue + i) % numQueues]->stealFront(task)) {
+                queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void runWorkerTask(const Task& task) {
+#ifdef CARDGAME_PROFILING
+        uint64_t start = Profiler::now();
+        runTask(task);
+        uint64_t end = Profiler::now();
+        Profiler::instance().record("Worker task", start, end);
+        busyTime.fetch_add(end - start, std::memory_order_relaxed);
+#else
+        runTask(task);
+#endif
+    }
+
+    void workerLoop(int index) {
+#ifdef CARDGAME_PROFILING
+        Profiler::instance().setThreadName("Worker " + std::to_string(index));
+#endif
+        while (true) {
+            Task task;
+            if (queues[index]->popBack(task)) {
+                queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+                runWorkerTask(task);
+                continue;
+            }
+            if (stealAny(index + 1, task)) {
+                runWorkerTask(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wakeUp.wait(lock, [this]() {
+                return stopping || queuedTasks.load(std::memory_order_acquire) > 0;
+            });
+            if (stopping) return;
+        }
+    }
+};
@@ -0,0 +1,243 @@
+#pragma once
+#include "AIWorkerPool.h"
+#include "CardAtlas.h"
+#include "AssetPack.h"
+#include "MemoryAudioFile.h"
+#include "stb_image.h"
+#include <sndfile.hh>
+#include <vector>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <system_error>
+#include <cstdint>
+
+// Pixels as decoded by stb_image, owned until freed or destroyed.
+struct DecodedImage {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    unsigned char* pixels = nullptr;
+
+    DecodedImage() = default;
+    DecodedImage(const DecodedImage&) = delete;
+    DecodedImage& operator=(const DecodedImage&) = delete;
+    ~DecodedImage() { free(); }
+
+    void free() {
+        if (pixels) stbi_image_free(pixels);
+        pixels = nullptr;
+    }
+};
+
+struct DecodedAudio {
+    std::vector<short> samples;
+    int channels = 0;
+    int sampleRate = 0;
+};
+
+// Decodes startup assets on its own worker threads while the GL thread keeps
+// drawing. Outputs are written into caller-owned objects, which must outlive
+// the loader; they are safe to read once isFinished() returns true. Assets
+// are named relative to assetRoot, or looked up in the pack when one is
+// given, in which case images and audio decode straight from its mapping. A
+// card atlas that has to be packed from the individual images is split into
+// one task per card and saved to atlasPath by whichever task finishes last;
+// a pre-compressed one from texconvert is used as it is.
+class AssetLoader {
+public:
+    AssetLoader(int numThreads, const std::string& assetRoot, const AssetPack* pack = nullptr)
+        : pool(numThreads), assetRoot(assetRoot), pack(pack), total(0), completed(0), atlasSlotsLeft(0) {
+        stbi_set_flip_vertically_on_load(true);
+    }
+
+    ~AssetLoader() {
+        pool.wait(group);
+    }
+
+    void loadImage(const std::string& name, DecodedImage& output) {
+        submit(&AssetLoader::runImage, name, &output, 0);
+    }
+
+    void loadAudio(const std::string& name, DecodedAudio& output) {
+        submit(&AssetLoader::runAudio, name, &output, 0);
+    }
+
+    // Prefers the compressed atlas unless allowCompressed is false, then the
+    // cache at atlasPath if it was packed from the current card images, then
+    // packing the card images.
+    void loadCardAtlas(const std::string& atlasPath, CardAtlas& output, bool allowCompressed) {
+        if (allowCompressed && hasAsset(CardAtlas::COMPRESSED_FILE)) {
+            submit(&AssetLoader::runAtlasCompressed, CardAtlas::COMPRESSED_FILE, &output, 0);
+            return;
+        }
+        atlasStamp = atlasSourceStamp();
+        if (CardAtlas::isCacheCurrent(atlasPath, atlasStamp)) {
+            submit(&AssetLoader::runAtlasFile, atlasPath, &output, 0);
+            return;
+        }
+
+        output.allocate();
+        atlasSavePath = atlasPath;
+        atlasSlotsLeft.store(CardAtlas::SLOT_COUNT, std::memory_order_relaxed);
+        for (int slot = 0; slot < CardAtlas::SLOT_COUNT; ++slot) {
+            submit(&AssetLoader::runAtlasSlot, std::string(), &output, slot);
+        }
+    }
+
+    int getTotal() const { return total; }
+    int getCompleted() const { return completed.load(std::memory_order_acquire); }
+    bool isFinished() const { return group.pending.load(std::memory_order_acquire) == 0; }
+
+    static bool decodeAudio(const std::string& path, DecodedAudio& output) {
+        SF_INFO fileInfo;
+        SNDFILE* file = sf_open(path.c_str(), SFM_READ, &fileInfo);
+        if (!file) {
+            std::cerr << "Failed to open audio file: " << path << std::endl;
+            return false;
+        }
+        readAudio(file, fileInfo, output);
+        return true;
+    }
+
+    static bool decodeAudio(const AssetView& bytes, DecodedAudio& output) {
+        MemoryAudioFile memoryFile;
+        SF_INFO fileInfo;
+        SNDFILE* file = memoryFile.open(bytes, fileInfo);
+        if (!file) return false;
+        readAudio(file, fileInfo, output);
+        return true;
+    }
+
+private:
+    struct Job {
+        AssetLoader* loader;
+        void (AssetLoader::*run)(Job& job);
+        std::string path;
+        void* output;
+        int slot;
+    };
+
+    AIWorkerPool pool;
+    AIWorkerPool::TaskGroup group;
+    std::vector<std::unique_ptr<Job>> jobs;
+    std::string assetRoot;
+    const AssetPack* pack;
+    int total;
+    std::atomic<int> completed;
+    std::atomic<int> atlasSlotsLeft;
+    std::string atlasSavePath;
+    uint64_t atlasStamp = 0;
+
+    static void readAudio(SNDFILE* file, const SF_INFO& fileInfo, DecodedAudio& output) {
+        output.samples.resize(static_cast<size_t>(fileInfo.frames * fileInfo.channels));
+        sf_readf_short(file, output.samples.data(), fileInfo.frames);
+        sf_close(file);
+        output.channels = fileInfo.channels;
+        output.sampleRate = fileInfo.samplerate;
+    }
+
+    bool hasAsset(const std::string& name) const {
+        if (pack) return static_cast<bool>(pack->find(name));
+        return static_cast<bool>(std::ifstream(assetRoot + name, std::ios::binary));
+    }
+
+    // The packed bytes of `name`; reports a miss.
+    AssetView findPacked(const std::string& name) const {
+        AssetView view = pack->find(name);
+        if (!view) {
+            std::cout << "Asset missing from pack: " << name << std::endl;
+        }
+        return view;
+    }
+
+    void submit(void (AssetLoader::*run)(Job& job), const std::string& path, void* output, int slot) {
+        jobs.emplace_back(new Job{ this, run, path, output, slot });
+        ++total;
+        pool.submit(group, [](void* context) {
+            PROFILE_SCOPE("Asset load");
+            Job& job = *static_cast<Job*>(context);
+            (job.loader->*job.run)(job);
+            job.loader->completed.fetch_add(1, std::memory_order_release);
+            }, jobs.back().get());
+    }
+
+    void runImage(Job& job) {
+        DecodedImage& image = *static_cast<DecodedImage*>(job.output);
+        if (pack) {
+            AssetView view = findPacked(job.path);
+            if (!view) return;
+            image.pixels = stbi_load_from_memory(view.data, static_cast<int>(view.size), &image.width, &image.height, &image.channels, 0);
+        }
+        else {
+            image.pixels = stbi_load((assetRoot + job.path).c_str(), &image.width, &image.height, &image.channels, 0);
+        }
+        if (!image.pixels) {
+            std::cout << "Failed to load texture: " << job.path << std::endl;
+        }
+    }
+
+    void runAudio(Job& job) {
+        DecodedAudio& audio = *static_cast<DecodedAudio*>(job.output);
+        if (!pack) {
+            decodeAudio(assetRoot + job.path, audio);
+        }
+        else if (AssetView view = findPacked(job.path)) {
+            if (!decodeAudio(view, audio)) {
+                std::cerr << "Failed to decode audio: " << job.path << std::endl;
+            }
+        }
+    }
+
+    // Identifies the card images: the size and modification time of each
+    // file, or of the pack holding them.
+    uint64_t atlasSourceStamp() const {
+        uint64_t stamp = 14695981039346656037ull;
+        auto mix = [&stamp](uint64_t value) { stamp = (stamp ^ value) * 1099511628211ull; };
+        if (pack) {
+            mix(pack->getFileSize());
+            mix(static_cast<uint64_t>(pack->getFileTime()));
+            return stamp;
+        }
+
+        for (int slot = 0; slot < CardAtlas::SLOT_COUNT; ++slot) {
+            std::string path = assetRoot + CardAtlas::imageName(slot);
+            std::error_code error;
+            uintmax_t size = std::filesystem::file_size(path, error);
+            mix(error ? 0 : static_cast<uint64_t>(size));
+            std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+            mix(error ? 0 : static_cast<uint64_t>(time.time_since_epoch().count()));
+        }
+        return stamp;
+    }
+
+    void runAtlasFile(Job& job) {
+        if (!static_cast<CardAtlas*>(job.output)->load(job.path, atlasStamp)) {
+            std::cout << "Failed to load card atlas: " << job.path << std::endl;
+        }
+    }
+
+    void runAtlasCompressed(Job& job) {
+        CompressedTexture texture;
+        bool parsed = pack ? texture.parse(pack->find(job.path)) : texture.load(assetRoot + job.path);
+        if (!parsed || !static_cast<CardAtlas*>(job.output)->loadCompressed(std::move(texture))) {
+            std::cout << "Failed to load compressed card atlas: " << job.path << std::endl;
+        }
+    }
+
+    void runAtlasSlot(Job& job) {
+        CardAtlas& atlas = *static_cast<CardAtlas*>(job.output);
+        if (pack) {
+            atlas.packSlot(findPacked(CardAtlas::imageName(job.slot)), job.slot);
+        }
+        else {
+            atlas.packSlot(assetRoot, job.slot);
+        }
+        if (atlasSlotsLeft.fetch_sub(1, std::memory_order_acq_rel) == 1 && atlas.save(atlasSavePath, atlasStamp)) {
+            std::cout << "Saved card atlas: " << atlasSavePath << std::endl;
+        }
+    }
+};
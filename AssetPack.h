@@ -0,0 +1,229 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+#include <cstring>
+#include <cstdint>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// The bytes of one packed file, pointing into the pack's mapping; valid while
+// the pack stays open.
+struct AssetView {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+// Every asset in one read-only file that is mapped into memory once, so
+// startup costs a single open and mmap instead of an open/read/close per
+// image, and decoders read straight out of the page cache. Layout: a 16-byte
+// header (magic, version, entry count, reserved), `count` 64-byte entries
+// sorted by name, then each file's bytes at a 16-byte aligned offset.
+class AssetPack {
+public:
+    static constexpr int NAME_LENGTH = 48;
+    static constexpr uint64_t ALIGNMENT = 16;
+
+    AssetPack() = default;
+    ~AssetPack() { close(); }
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+        if (!map(path)) return false;
+
+        const Header* header = reinterpret_cast<const Header*>(base);
+        if (mappedSize < sizeof(Header) || header->magic != MAGIC || header->version != VERSION ||
+            header->count > (mappedSize - sizeof(Header)) / sizeof(Entry)) {
+            std::cerr << "Not an asset pack: " << path << std::endl;
+            close();
+            return false;
+        }
+
+        entries = reinterpret_cast<const Entry*>(base + sizeof(Header));
+        for (uint32_t i = 0; i < header->count; ++i) {
+            const Entry& entry = entries[i];
+            if (entry.name[NAME_LENGTH - 1] != '\0' || entry.offset > mappedSize || entry.size > mappedSize - entry.offset) {
+                std::cerr << "Corrupt asset pack: " << path << std::endl;
+                close();
+                return false;
+            }
+        }
+        count = header->count;
+        std::error_code error;
+        fileTime = static_cast<int64_t>(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+        return true;
+    }
+
+    void close() {
+        if (base) {
+#ifdef _WIN32
+            UnmapViewOfFile(base);
+#else
+            munmap(const_cast<unsigned char*>(base), mappedSize);
+#endif
+        }
+        base = nullptr;
+        mappedSize = 0;
+        entries = nullptr;
+        count = 0;
+        fileTime = 0;
+    }
+
+    bool isOpen() const { return base != nullptr; }
+    int getCount() const { return static_cast<int>(count); }
+
+    // Size and modification time of the pack file, for caches built from its contents.
+    uint64_t getFileSize() const { return mappedSize; }
+    int64_t getFileTime() const { return fileTime; }
+
+    // Binary search over the sorted index; an empty view if the name is missing.
+    AssetView find(const std::string& name) const {
+        const Entry* end = entries + count;
+        const Entry* entry = std::lower_bound(entries, end, name, [](const Entry& e, const std::string& key) {
+            return std::strcmp(e.name, key.c_str()) < 0;
+            });
+        if (entry == end || name != entry->name) return AssetView();
+        return AssetView{ base + entry->offset, static_cast<size_t>(entry->size) };
+    }
+
+    // Packs every regular file under the dirs, named by its path relative to
+    // its dir with '/' separators; on a name clash the later dir wins.
+    static bool write(const std::vector<std::string>& dirs, const std::string& packPath) {
+        namespace fs = std::filesystem;
+        std::error_code error, missing;
+        std::vector<std::pair<std::string, fs::path>> files;
+        for (const std::string& dir : dirs) {
+            for (fs::recursive_directory_iterator it(dir, error), last; !error && it != last; it.increment(error)) {
+                if (!it->is_regular_file() || fs::equivalent(it->path(), packPath, missing)) continue;
+                std::string name = it->path().lexically_relative(dir).generic_string();
+                if (name.size() >= static_cast<size_t>(NAME_LENGTH)) {
+                    std::cerr << "Asset name too long, skipped: " << name << std::endl;
+                    continue;
+                }
+                files.emplace_back(name, it->path());
+            }
+            if (error) {
+                std::cerr << "Failed to list assets: " << dir << std::endl;
+                return false;
+            }
+        }
+        std::stable_sort(files.begin(), files.end(), [](const std::pair<std::string, fs::path>& a, const std::pair<std::string, fs::path>& b) {
+            return a.first < b.first;
+            });
+        size_t kept = 0;
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (i + 1 < files.size() && files[i + 1].first == files[i].first) continue;
+            files[kept++] = files[i];
+        }
+        files.resize(kept);
+
+        std::vector<Entry> index(files.size());
+        uint64_t offset = sizeof(Header) + index.size() * sizeof(Entry);
+        for (size_t i = 0; i < files.size(); ++i) {
+            offset = alignUp(offset);
+            std::strncpy(index[i].name, files[i].first.c_str(), NAME_LENGTH);
+            index[i].offset = offset;
+            index[i].size = fs::file_size(files[i].second, error);
+            if (error) return false;
+            offset += index[i].size;
+        }
+
+        std::ofstream out(packPath, std::ios::binary);
+        if (!out) return false;
+        Header header = { MAGIC, VERSION, static_cast<uint32_t>(index.size()), 0 };
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(Entry));
+
+        std::vector<char> bytes;
+        for (size_t i = 0; i < files.size(); ++i) {
+            static const char zeros[ALIGNMENT] = {};
+            out.write(zeros, static_cast<std::streamsize>(index[i].offset - static_cast<uint64_t>(out.tellp())));
+
+            bytes.resize(static_cast<size_t>(index[i].size));
+            std::ifstream in(files[i].second, std::ios::binary);
+            if (!in.read(bytes.data(), bytes.size())) {
+                std::cerr << "Failed to read asset: " << files[i].second.string() << std::endl;
+                return false;
+            }
+            out.write(bytes.data(), bytes.size());
+        }
+        return static_cast<bool>(out);
+    }
+
+private:
+    static constexpr uint32_t MAGIC = 0x4B415041;  // "APAK"
+    static constexpr uint32_t VERSION = 1;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t count;
+        uint32_t reserved;
+    };
+
+    struct Entry {
+        char name[NAME_LENGTH];
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    const unsigned char* base = nullptr;
+    size_t mappedSize = 0;
+    const Entry* entries = nullptr;
+    uint32_t count = 0;
+    int64_t fileTime = 0;
+
+    static uint64_t alignUp(uint64_t offset) {
+        return (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    // Maps the whole file read-only; the descriptors are closed right away
+    // since the mapping keeps the file alive.
+    bool map(const std::string& path) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        HANDLE mapping = nullptr;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        }
+        CloseHandle(file);
+        if (!mapping) return false;
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!view) return false;
+        mappedSize = static_cast<size_t>(size.QuadPart);
+#else
+        int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) return false;
+        struct stat info;
+        void* view = MAP_FAILED;
+        if (fstat(file, &info) == 0 && info.st_size > 0) {
+            view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        }
+        ::close(file);
+        if (view == MAP_FAILED) return false;
+        mappedSize = static_cast<size_t>(info.st_size);
+#endif
+        base = static_cast<const unsigned char*>(view);
+        return true;
+    }
+};
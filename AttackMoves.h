@@ -0,0 +1,43 @@
+#pragma once
+#include "CardMask.h"
+
+// Attack moves as card sets: an opening of 1-3 cards of one rank, or a
+// throw-in of 1-3 cards of a rank already on the table. A move is packed as
+// the CardMask of its cards; ATTACK_END, the empty set, stops attacking.
+typedef CardMask AttackMove;
+
+const AttackMove ATTACK_END = 0;
+const int MAX_ATTACK_CARDS = 3;
+
+// Six suited ranks with 4 + 6 + 4 sets of up to three of their four cards,
+// the three joker sets, and END.
+const int MAX_ATTACK_MOVES = 6 * 14 + 3 + 1;
+
+struct AttackMoveList {
+    AttackMove moves[MAX_ATTACK_MOVES];
+    int count = 0;
+};
+
+// Lists every legal attack set of at most maxCards cards (the rules allow
+// three; fewer when the defender holds fewer cards), grouped by rank. END
+// comes last whenever the table is not empty.
+inline void generateAttackMoves(CardMask hand, CardMask tableMask, int maxCards, AttackMoveList& list) {
+    int count = 0;
+    CardMask allowed = tableMask == 0 ? hand : hand & sameRankMask(tableMask);
+
+    // rankMask(CARDS_PER_SUIT) is the joker pair.
+    for (int rank = 0; rank <= CARDS_PER_SUIT && allowed; ++rank) {
+        CardMask group = allowed & rankMask(rank);
+        allowed &= ~group;
+        for (CardMask subset = group; subset; subset = (subset - 1) & group) {
+            if (cardCount(subset) <= maxCards) {
+                list.moves[count++] = subset;
+            }
+        }
+    }
+
+    if (tableMask != 0) {
+        list.moves[count++] = ATTACK_END;
+    }
+    list.count = count;
+}
@@ -0,0 +1,160 @@
+#pragma once
+#include "MemoryAudioFile.h"
+#include <AL/al.h>
+#include <sndfile.hh>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <cstdio>
+
+// Plays a long track without decoding it up front. A background thread reads
+// CHUNK_FRAMES at a time with libsndfile into a ring of BUFFER_COUNT AL
+// buffers queued on one source, refilling each buffer as the source finishes
+// with it. Memory stays at BUFFER_COUNT chunks whatever the track length.
+class AudioStream {
+public:
+    static constexpr int BUFFER_COUNT = 4;
+    static constexpr int CHUNK_FRAMES = 8192;
+
+    AudioStream() : file(nullptr), source(0), format(0), sampleRate(0), looping(false), running(false) {}
+
+    ~AudioStream() {
+        stop();
+    }
+
+    AudioStream(const AudioStream&) = delete;
+    AudioStream& operator=(const AudioStream&) = delete;
+
+    // Starts playback as soon as the first chunks are decoded.
+    bool play(const std::string& filePath, bool loop) {
+        stop();
+
+        SF_INFO fileInfo;
+        file = sf_open(filePath.c_str(), SFM_READ, &fileInfo);
+        if (!file) {
+            std::cerr << "Failed to open audio file: " << filePath << std::endl;
+            return false;
+        }
+        start(fileInfo, loop);
+        return true;
+    }
+
+    // Streams a track held in memory, typically an AssetPack view; the bytes
+    // must stay valid until stop().
+    bool play(const AssetView& track, bool loop) {
+        stop();
+
+        SF_INFO fileInfo;
+        file = memoryFile.open(track, fileInfo);
+        if (!file) {
+            std::cerr << "Failed to open audio track: " << sf_strerror(nullptr) << std::endl;
+            return false;
+        }
+        start(fileInfo, loop);
+        return true;
+    }
+
+    void stop() {
+        if (streamThread.joinable()) {
+            running = false;
+            streamThread.join();
+        }
+        if (source) {
+            alSourceStop(source);
+            alSourcei(source, AL_BUFFER, 0);
+            alDeleteSources(1, &source);
+            alDeleteBuffers(BUFFER_COUNT, buffers);
+            source = 0;
+        }
+        if (file) {
+            sf_close(file);
+            file = nullptr;
+        }
+    }
+
+    void setVolume(float volume) {
+        gain = volume;
+        if (source) alSourcef(source, AL_GAIN, volume);
+    }
+
+private:
+    SNDFILE* file;
+    MemoryAudioFile memoryFile;
+    ALuint source;
+    ALuint buffers[BUFFER_COUNT];
+    ALenum format;
+    int sampleRate;
+    int channels = 0;
+    float gain = 1.0f;
+    bool looping;
+    std::vector<short> chunk;
+    std::thread streamThread;
+    std::atomic<bool> running;
+
+    void start(const SF_INFO& fileInfo, bool loop) {
+        format = fileInfo.channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+        sampleRate = fileInfo.samplerate;
+        looping = loop;
+        chunk.resize(static_cast<size_t>(CHUNK_FRAMES) * fileInfo.channels);
+        channels = fileInfo.channels;
+
+        alGenSources(1, &source);
+        alGenBuffers(BUFFER_COUNT, buffers);
+        int queued = 0;
+        while (queued < BUFFER_COUNT && fillBuffer(buffers[queued])) {
+            ++queued;
+        }
+        alSourceQueueBuffers(source, queued, buffers);
+        alSourcef(source, AL_GAIN, gain);
+        alSourcePlay(source);
+
+        running = true;
+        streamThread = std::thread([this]() { streamLoop(); });
+    }
+
+    // Decodes the next chunk into `buffer`; false once the track is over.
+    bool fillBuffer(ALuint buffer) {
+        sf_count_t frames = sf_readf_short(file, chunk.data(), CHUNK_FRAMES);
+        if (frames <= 0 && looping) {
+            sf_seek(file, 0, SEEK_SET);
+            frames = sf_readf_short(file, chunk.data(), CHUNK_FRAMES);
+        }
+        if (frames <= 0) return false;
+
+        alBufferData(buffer, format, chunk.data(), static_cast<ALsizei>(frames * channels * sizeof(short)), sampleRate);
+        return true;
+    }
+
+    void streamLoop() {
+        bool finished = false;
+        while (running) {
+            ALint processed = 0;
+            alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+            while (processed-- > 0 && !finished) {
+                ALuint buffer;
+                alSourceUnqueueBuffers(source, 1, &buffer);
+                if (fillBuffer(buffer)) {
+                    alSourceQueueBuffers(source, 1, &buffer);
+                }
+                else {
+                    finished = true;
+                }
+            }
+
+            ALint state, queued;
+            alGetSourcei(source, AL_SOURCE_STATE, &state);
+            alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+            alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+            if (state != AL_PLAYING) {
+                // Either the queue ran dry before it was refilled, or the track is over.
+                if (queued > processed) alSourcePlay(source);
+                else if (finished) return;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+};
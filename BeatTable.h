@@ -0,0 +1,48 @@
+#pragma once
+#include "CardMask.h"
+
+const int NO_TRUMP = 4;
+
+// beatingCards[trump][attackId] is the set of cards that beat attackId when
+// `trump` is the trump suit (NO_TRUMP before the deal). Built at compile time,
+// so every beat query in the rules and the AI is one load.
+struct BeatTable {
+    CardMask beatingCards[NO_TRUMP + 1][CARD_COUNT];
+};
+
+constexpr CardMask computeBeatingCards(int attackId, int trumpSuit) {
+    if (attackId >= 24) {
+        return JOKER_MASK;
+    }
+
+    int suit = attackId / CARDS_PER_SUIT;
+    int rank = attackId % CARDS_PER_SUIT;
+    CardMask beaters = JOKER_MASK | (suitMask(suit) & ~((cardBit(attackId) << 1) - 1));
+
+    // "Народные массы": the two of a suit beats that suit's ace.
+    if (rank == CARDS_PER_SUIT - 1) {
+        beaters |= cardBit(suit * CARDS_PER_SUIT);
+    }
+
+    if (suit != trumpSuit) {
+        beaters |= suitMask(trumpSuit);
+    }
+    return beaters;
+}
+
+constexpr BeatTable buildBeatTable() {
+    BeatTable beatTable = {};
+    for (int trump = 0; trump <= NO_TRUMP; ++trump) {
+        for (int attackId = 0; attackId < CARD_COUNT; ++attackId) {
+            beatTable.beatingCards[trump][attackId] = computeBeatingCards(attackId, trump);
+        }
+    }
+    return beatTable;
+}
+
+inline constexpr BeatTable BEAT_TABLE = buildBeatTable();
+
+static_assert(BEAT_TABLE.beatingCards[NO_TRUMP][5] & cardBit(0), "two of spades beats ace of spades");
+static_assert(!(BEAT_TABLE.beatingCards[NO_TRUMP][0] & cardBit(11)), "ace of hearts does not beat two of spades");
+static_assert(BEAT_TABLE.beatingCards[1][5] & cardBit(6), "any trump beats a plain ace");
+static_assert(BEAT_TABLE.beatingCards[0][24] == JOKER_MASK, "only a joker beats a joker");
@@ -0,0 +1,57 @@
+#pragma once
+#include <string>
+
+class Card {
+public:
+    enum Suit {
+        SPADES = 0,     
+        HEARTS = 1,         
+        DIAMONDS = 2,       
+        CLUBS = 3,          
+        BLACK = 4,
+        RED = 5
+    };
+
+    enum Rank {
+        TWO = 0,       
+        TEN = 1,      
+        JACK = 2,    
+        QUEEN = 3,   
+        KING = 4,  
+        ACE = 5,      
+        JOKER_RANK = 6 
+    };
+
+    Suit suit;
+    Rank rank;
+    int id; 
+
+    Card() : suit(SPADES), rank(TWO), id(-1) {}
+
+    Card(Suit s, Rank r, int cardId) : suit(s), rank(r), id(cardId) {}
+
+    static Suit suitOf(int cardId) {
+        if (cardId >= 24) return cardId == 24 ? BLACK : RED;
+        return static_cast<Suit>(cardId / 6);
+    }
+
+    static Rank rankOf(int cardId) {
+        if (cardId >= 24) return JOKER_RANK;
+        return static_cast<Rank>(cardId % 6);
+    }
+
+    static Card fromId(int cardId) {
+        return Card(suitOf(cardId), rankOf(cardId), cardId);
+    }
+
+    // Image file name for this card's face as shipped in textures/, prefixed with assetRoot.
+    std::string getTextureName(const std::string& assetRoot = "") const {
+        if (rank == JOKER_RANK) {
+            return assetRoot + (suit == RED ? "red_joker.png" : "black_joker.png");
+        }
+
+        static const char* suitNames[] = { "spades", "hearts", "diominds", "clubs" };
+        static const char* rankNames[] = { "2", "10", "jack", "queen", "king", "ace" };
+        return assetRoot + rankNames[rank] + "_of_" + suitNames[suit] + ".png";
+    }
+};
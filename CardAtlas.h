@@ -0,0 +1,222 @@
+#pragma once
+#include "Card.h"
+#include "AssetPack.h"
+#include "CompressedTexture.h"
+#include "stb_image.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+struct AtlasRect {
+    float u0, v0, u1, v1;
+};
+
+// All 27 card images (24 faces, 2 jokers, the back) packed into one RGBA
+// image, scaled down to their display size and laid out in a 6 x 5 grid. Rows are
+// stored bottom-up, as GL expects, and every cell has an edge-extended border
+// so mipmaps do not bleed between neighbours. texconvert can ship the atlas
+// pre-compressed with its mip chain (cards.ktx), which replaces the pixels.
+class CardAtlas {
+public:
+    static constexpr int SLOT_COUNT = 27;
+    static constexpr int BACK_SLOT = 26;
+    static constexpr int COLUMNS = 6;
+    static constexpr int ROWS = 5;
+    static constexpr int CELL_WIDTH = 80;   // CARD_WIDTH x CARD_HEIGHT, the size cards are drawn at
+    static constexpr int CELL_HEIGHT = 120;
+    static constexpr int PADDING = 4;
+    static constexpr const char* COMPRESSED_FILE = "cards.ktx";
+
+    static int slotFor(Card::Suit suit, Card::Rank rank) {
+        if (rank == Card::JOKER_RANK) return suit == Card::RED ? 25 : 24;
+        return suit * 6 + rank;
+    }
+
+    static int slotFor(int cardId, bool faceUp) {
+        return faceUp ? slotFor(Card::suitOf(cardId), Card::rankOf(cardId)) : BACK_SLOT;
+    }
+
+    static std::string imageName(int slot) {
+        if (slot == BACK_SLOT) return "card_back.jpg";
+        return Card::fromId(slot).getTextureName();
+    }
+
+    // Decodes every card image in textureDir and packs it. Missing images
+    // leave a transparent cell; returns false if any were missing.
+    bool build(const std::string& textureDir) {
+        allocate();
+        stbi_set_flip_vertically_on_load(true);
+
+        bool complete = true;
+        for (int slot = 0; slot < SLOT_COUNT; ++slot) {
+            complete = packSlot(textureDir, slot) && complete;
+        }
+        return complete;
+    }
+
+    // Sizes the pixel buffer and lays out the UV rects; packSlot() then fills
+    // cells independently, so different slots can be packed on different threads.
+    void allocate() {
+        layout();
+        pixels.assign(static_cast<size_t>(width) * height * 4, 0);
+    }
+
+    // Takes a cards.ktx written by texconvert, whose bytes must outlive the
+    // atlas (an AssetPack view, or the texture's own storage).
+    bool loadCompressed(CompressedTexture&& texture) {
+        layout();
+        if (texture.getWidth() != width || texture.getHeight() != height) return false;
+        compressed = std::move(texture);
+        return true;
+    }
+
+    bool packSlot(const std::string& textureDir, int slot) {
+        std::string filename = textureDir + imageName(slot);
+        int imageWidth, imageHeight, channels;
+        unsigned char* data = stbi_load(filename.c_str(), &imageWidth, &imageHeight, &channels, 4);
+        if (!data) {
+            std::cout << "Failed to load texture: " << filename << std::endl;
+            return false;
+        }
+        packDecoded(data, imageWidth, imageHeight, slot);
+        return true;
+    }
+
+    // Same, decoding the encoded image file held in `file` (e.g. an AssetPack view).
+    bool packSlot(const AssetView& file, int slot) {
+        int imageWidth, imageHeight, channels;
+        unsigned char* data = file ? stbi_load_from_memory(file.data, static_cast<int>(file.size), &imageWidth, &imageHeight, &channels, 4) : nullptr;
+        if (!data) {
+            std::cout << "Failed to load texture: " << imageName(slot) << std::endl;
+            return false;
+        }
+        packDecoded(data, imageWidth, imageHeight, slot);
+        return true;
+    }
+
+    // The cache written after packing the card images. sourceStamp identifies
+    // the images it was packed from; load() refuses a cache with another one.
+    bool save(const std::string& path, uint64_t sourceStamp) const {
+        std::ofstream file(path, std::ios::binary);
+        if (!file) return false;
+
+        uint32_t header[HEADER_WORDS] = { MAGIC, VERSION, static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+            static_cast<uint32_t>(sourceStamp), static_cast<uint32_t>(sourceStamp >> 32) };
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(rects), sizeof(rects));
+        file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+        return static_cast<bool>(file);
+    }
+
+    bool load(const std::string& path, uint64_t sourceStamp) {
+        std::ifstream file(path, std::ios::binary);
+        uint32_t header[HEADER_WORDS];
+        if (!readHeader(file, sourceStamp, header)) return false;
+
+        width = static_cast<int>(header[2]);
+        height = static_cast<int>(header[3]);
+        file.read(reinterpret_cast<char*>(rects), sizeof(rects));
+        pixels.resize(static_cast<size_t>(width) * height * 4);
+        file.read(reinterpret_cast<char*>(pixels.data()), pixels.size());
+        return static_cast<bool>(file);
+    }
+
+    // True if path holds a cache packed from the images sourceStamp identifies.
+    static bool isCacheCurrent(const std::string& path, uint64_t sourceStamp) {
+        std::ifstream file(path, std::ios::binary);
+        uint32_t header[HEADER_WORDS];
+        return readHeader(file, sourceStamp, header);
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const unsigned char* getPixels() const { return pixels.data(); }
+    const CompressedTexture& getCompressed() const { return compressed; }
+    bool isCompressed() const { return !compressed.empty(); }
+    bool isEmpty() const { return pixels.empty() && compressed.empty(); }
+    const AtlasRect& getRect(int slot) const { return rects[slot]; }
+
+    void releasePixels() {
+        std::vector<unsigned char>().swap(pixels);
+        compressed.release();
+    }
+
+private:
+    static constexpr uint32_t MAGIC = 0x4C544143;  // "CATL"
+    static constexpr uint32_t VERSION = 2;
+    // magic, version, width, height, source stamp (low and high words).
+    static constexpr int HEADER_WORDS = 6;
+
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;
+    CompressedTexture compressed;
+    AtlasRect rects[SLOT_COUNT] = {};
+
+    static bool readHeader(std::ifstream& file, uint64_t sourceStamp, uint32_t* header) {
+        if (!file.read(reinterpret_cast<char*>(header), HEADER_WORDS * sizeof(uint32_t))) return false;
+        return header[0] == MAGIC && header[1] == VERSION &&
+            header[4] == static_cast<uint32_t>(sourceStamp) && header[5] == static_cast<uint32_t>(sourceStamp >> 32);
+    }
+
+    // Atlas size and the UV rect of every cell.
+    void layout() {
+        width = COLUMNS * (CELL_WIDTH + 2 * PADDING);
+        height = ROWS * (CELL_HEIGHT + 2 * PADDING);
+
+        for (int slot = 0; slot < SLOT_COUNT; ++slot) {
+            int cellX = (slot % COLUMNS) * (CELL_WIDTH + 2 * PADDING);
+            int cellY = (slot / COLUMNS) * (CELL_HEIGHT + 2 * PADDING);
+            rects[slot] = {
+                static_cast<float>(cellX + PADDING) / width,
+                static_cast<float>(cellY + PADDING) / height,
+                static_cast<float>(cellX + PADDING + CELL_WIDTH) / width,
+                static_cast<float>(cellY + PADDING + CELL_HEIGHT) / height
+            };
+        }
+    }
+
+    // Packs and frees an RGBA image from stb_image.
+    void packDecoded(unsigned char* data, int imageWidth, int imageHeight, int slot) {
+        packCell(data, imageWidth, imageHeight, (slot % COLUMNS) * (CELL_WIDTH + 2 * PADDING),
+            (slot / COLUMNS) * (CELL_HEIGHT + 2 * PADDING));
+        stbi_image_free(data);
+    }
+
+    // Box-filters the image into the cell, then copies the cell's edge pixels
+    // into its padding.
+    void packCell(const unsigned char* data, int imageWidth, int imageHeight, int cellX, int cellY) {
+        for (int y = -PADDING; y < CELL_HEIGHT + PADDING; ++y) {
+            int cy = std::min(std::max(y, 0), CELL_HEIGHT - 1);
+            int y0 = cy * imageHeight / CELL_HEIGHT;
+            int y1 = std::max(y0 + 1, (cy + 1) * imageHeight / CELL_HEIGHT);
+
+            for (int x = -PADDING; x < CELL_WIDTH + PADDING; ++x) {
+                int cx = std::min(std::max(x, 0), CELL_WIDTH - 1);
+                int x0 = cx * imageWidth / CELL_WIDTH;
+                int x1 = std::max(x0 + 1, (cx + 1) * imageWidth / CELL_WIDTH);
+
+                unsigned int sum[4] = { 0, 0, 0, 0 };
+                for (int sy = y0; sy < y1; ++sy) {
+                    const unsigned char* row = data + (static_cast<size_t>(sy) * imageWidth + x0) * 4;
+                    for (int sx = x0; sx < x1; ++sx, row += 4) {
+                        sum[0] += row[0];
+                        sum[1] += row[1];
+                        sum[2] += row[2];
+                        sum[3] += row[3];
+                    }
+                }
+
+                unsigned int count = static_cast<unsigned int>((y1 - y0) * (x1 - x0));
+                unsigned char* out = &pixels[(static_cast<size_t>(cellY + PADDING + y) * width + cellX + PADDING + x) * 4];
+                for (int c = 0; c < 4; ++c) {
+                    out[c] = static_cast<unsigned char>(sum[c] / count);
+                }
+            }
+        }
+    }
+};
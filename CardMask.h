@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// A set of cards from the 26-card deck, one bit per card id.
+// Ids follow createFullDeck(): suit * 6 + rank for the 24 suited cards,
+// then 24 = black joker, 25 = red joker.
+typedef uint32_t CardMask;
+
+const int CARD_COUNT = 26;
+const int CARDS_PER_SUIT = 6;
+
+const CardMask FULL_DECK_MASK = (1u << CARD_COUNT) - 1;
+const CardMask JOKER_MASK = 3u << 24;
+
+constexpr CardMask cardBit(int cardId) {
+    return 1u << cardId;
+}
+
+constexpr CardMask suitMask(int suit) {
+    return suit >= 0 && suit < 4 ? 0x3Fu << (suit * CARDS_PER_SUIT) : 0u;
+}
+
+constexpr CardMask rankMask(int rank) {
+    return rank < 6 ? 0x41041u << rank : JOKER_MASK;
+}
+
+// Every card sharing a rank with some card in mask.
+constexpr CardMask sameRankMask(CardMask mask) {
+    return (((mask | mask >> 6 | mask >> 12 | mask >> 18) & 0x3Fu) * 0x41041u) | ((mask & JOKER_MASK) ? JOKER_MASK : 0u);
+}
+
+inline int cardCount(CardMask mask) {
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt(mask));
+#else
+    return __builtin_popcount(mask);
+#endif
+}
+
+// Id of the lowest card in a non-empty mask.
+inline int lowestCard(CardMask mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Hands are ordered by card id, so a hand index is the number of lower cards in the mask.
+inline int cardAtIndex(CardMask mask, int index) {
+    for (int i = 0; i < index; ++i) {
+        mask &= mask - 1;
+    }
+    return mask ? lowestCard(mask) : -1;
+}
+
+inline int indexOfCard(CardMask mask, int cardId) {
+    return cardCount(mask & (cardBit(cardId) - 1));
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "CardMask.h"
+#include "GamePosition.h"
+#include <utility>
+
+// What each side can tell about the other's hand from public events alone:
+// cards it watched the other pick up from the table (definitely held until
+// played), cards that left the game (discards and the face-up trump), and
+// cards the other probably lacks because it took instead of beating an attack
+// (forgotten again once it draws unseen cards). A take can be voluntary, so
+// ruled-out cards are only unlikely, never excluded. Every update is a few
+// mask operations.
+class CardTracker {
+public:
+    CardTracker() { reset(); }
+
+    void reset() {
+        held[SIDE_PLAYER] = held[SIDE_COMPUTER] = 0;
+        lacks[SIDE_PLAYER] = lacks[SIDE_COMPUTER] = 0;
+        gone = 0;
+    }
+
+    void onTrump(int cardId) { gone |= cardBit(cardId); }
+
+    void onPlay(int side, int cardId) { held[side] &= ~cardBit(cardId); }
+
+    // The defender took the table instead of beating attackId: everything
+    // that beats it is probably out of its hand, apart from cards it is known
+    // to hold.
+    void onTake(int side, CardMask table, CardMask beatersOfAttack) {
+        held[side] |= table;
+        lacks[side] |= beatersOfAttack & ~held[side];
+    }
+
+    void onDiscard(CardMask table) { gone |= table; }
+
+    void onDraw(int side) { lacks[side] = 0; }
+
+    // Lets the player AI reason from the player's seat.
+    void swapSides() {
+        std::swap(held[SIDE_PLAYER], held[SIDE_COMPUTER]);
+        std::swap(lacks[SIDE_PLAYER], lacks[SIDE_COMPUTER]);
+    }
+
+    CardMask getGone() const { return gone; }
+    CardMask definitelyHeld(int side) const { return held[side]; }
+    CardMask ruledOut(int side) const { return lacks[side]; }
+
+    // Cards `side` may hold as seen by the other side, whose own hand is
+    // observerHand; includes the cards it definitely holds and those ruled out.
+    CardMask possiblyHeld(int side, CardMask observerHand, CardMask tableMask) const {
+        return (FULL_DECK_MASK & ~(gone | tableMask | observerHand)) | held[side];
+    }
+
+private:
+    CardMask held[2];
+    CardMask lacks[2];
+    CardMask gone;
+};
@@ -0,0 +1,126 @@
+#pragma once
+#include "AssetPack.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+// A block-compressed texture with its whole mip chain, stored as a KTX 1.1
+// file (one face, no array layers, no key/value data) so standard tools can
+// inspect it. Levels point into the bytes it was parsed from: an AssetPack
+// mapping, or `storage` when loaded from a loose file or encoded in memory.
+// texconvert writes these with TextureCompressor; TextureManager uploads the
+// levels as they are.
+struct CompressedTexture {
+    // GL_EXT_texture_compression_s3tc internal formats.
+    static constexpr uint32_t BC1_RGB = 0x83F0;
+    static constexpr uint32_t BC1_RGBA = 0x83F1;
+    static constexpr uint32_t BC3_RGBA = 0x83F3;
+
+    struct Level {
+        int width;
+        int height;
+        const unsigned char* data;
+        size_t size;
+    };
+
+    uint32_t format = 0;
+    std::vector<Level> levels;
+    std::vector<unsigned char> storage;
+
+    bool empty() const { return levels.empty(); }
+    int getWidth() const { return levels.empty() ? 0 : levels[0].width; }
+    int getHeight() const { return levels.empty() ? 0 : levels[0].height; }
+
+    void release() {
+        levels.clear();
+        std::vector<unsigned char>().swap(storage);
+    }
+
+    static int blockBytes(uint32_t format) { return format == BC3_RGBA ? 16 : 8; }
+
+    static size_t levelSize(uint32_t format, int width, int height) {
+        return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockBytes(format);
+    }
+
+    // Reads the level table out of KTX bytes, which must outlive the levels.
+    bool parse(const unsigned char* bytes, size_t size) {
+        levels.clear();
+        uint32_t header[HEADER_WORDS];
+        if (size < sizeof(IDENTIFIER) + sizeof(header) || std::memcmp(bytes, IDENTIFIER, sizeof(IDENTIFIER)) != 0) return false;
+        std::memcpy(header, bytes + sizeof(IDENTIFIER), sizeof(header));
+        if (header[0] != ENDIANNESS || header[1] != 0 || !isSupported(header[4]) || header[6] == 0 || header[7] == 0 ||
+            header[8] != 0 || header[9] != 0 || header[10] != 1 || header[11] == 0) {
+            return false;
+        }
+
+        format = header[4];
+        int width = static_cast<int>(header[6]);
+        int height = static_cast<int>(header[7]);
+        size_t offset = sizeof(IDENTIFIER) + sizeof(header) + header[12];
+        for (uint32_t i = 0; i < header[11]; ++i) {
+            uint32_t imageSize;
+            if (offset > size || size - offset < sizeof(imageSize)) return failParse();
+            std::memcpy(&imageSize, bytes + offset, sizeof(imageSize));
+            offset += sizeof(imageSize);
+            if (imageSize < levelSize(format, width, height) || imageSize > size - offset) return failParse();
+
+            levels.push_back({ width, height, bytes + offset, imageSize });
+            offset += (imageSize + 3) & ~3u;
+            width = std::max(1, width / 2);
+            height = std::max(1, height / 2);
+        }
+        return true;
+    }
+
+    bool parse(const AssetView& file) { return file && parse(file.data, file.size); }
+
+    bool load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        storage.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return parse(storage.data(), storage.size());
+    }
+
+    bool save(const std::string& path) const {
+        std::ofstream file(path, std::ios::binary);
+        if (!file || levels.empty()) return false;
+
+        uint32_t header[HEADER_WORDS] = {
+            ENDIANNESS, 0, 1, 0, format, format == BC1_RGB ? BASE_RGB : BASE_RGBA,
+            static_cast<uint32_t>(getWidth()), static_cast<uint32_t>(getHeight()), 0, 0, 1,
+            static_cast<uint32_t>(levels.size()), 0
+        };
+        file.write(reinterpret_cast<const char*>(IDENTIFIER), sizeof(IDENTIFIER));
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        for (const Level& level : levels) {
+            // Block sizes are multiples of 8, so levels need no padding.
+            uint32_t imageSize = static_cast<uint32_t>(level.size);
+            file.write(reinterpret_cast<const char*>(&imageSize), sizeof(imageSize));
+            file.write(reinterpret_cast<const char*>(level.data), level.size);
+        }
+        return static_cast<bool>(file);
+    }
+
+private:
+    // endianness, glType, glTypeSize, glFormat, glInternalFormat,
+    // glBaseInternalFormat, width, height, depth, array elements, faces,
+    // mip levels, key/value bytes.
+    static constexpr int HEADER_WORDS = 13;
+    static constexpr uint32_t ENDIANNESS = 0x04030201;
+    static constexpr uint32_t BASE_RGB = 0x1907;
+    static constexpr uint32_t BASE_RGBA = 0x1908;
+    static constexpr unsigned char IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+    static bool isSupported(uint32_t format) {
+        return format == BC1_RGB || format == BC1_RGBA || format == BC3_RGBA;
+    }
+
+    bool failParse() {
+        levels.clear();
+        return false;
+    }
+};
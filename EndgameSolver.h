@@ -0,0 +1,253 @@
+#pragma once
+#include "GamePosition.h"
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+// Zobrist keys for (player hand, computer hand, table, last table card,
+// trump, state). Each mask is hashed a byte at a time through tables that
+// are the XOR of the per-card keys, so hashing a position is a dozen loads.
+class ZobristKeys {
+public:
+    static const ZobristKeys& instance() {
+        static const ZobristKeys keys;
+        return keys;
+    }
+
+    uint64_t hash(const GamePosition& position) const {
+        uint64_t key = hashMask(0, position.hands[SIDE_PLAYER]) ^
+            hashMask(1, position.hands[SIDE_COMPUTER]) ^
+            hashMask(2, position.tableMask);
+        if (position.tableMask != 0) {
+            key ^= lastCardKeys[position.lastTableCard];
+        }
+        return key ^ trumpKeys[position.trumpSuit] ^ stateKeys[static_cast<int>(position.state)];
+    }
+
+private:
+    uint64_t byteKeys[3][4][256];
+    uint64_t lastCardKeys[CARD_COUNT];
+    uint64_t trumpKeys[NO_TRUMP + 1];
+    uint64_t stateKeys[6];
+
+    static uint64_t splitMix(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    ZobristKeys() {
+        uint64_t seed = 0x5EED5EEDull;
+        for (int location = 0; location < 3; ++location) {
+            uint64_t cardKeys[32];
+            for (int card = 0; card < 32; ++card) {
+                cardKeys[card] = splitMix(seed);
+            }
+            for (int byte = 0; byte < 4; ++byte) {
+                for (int value = 0; value < 256; ++value) {
+                    uint64_t key = 0;
+                    for (int bit = 0; bit < 8; ++bit) {
+                        if (value & (1 << bit)) key ^= cardKeys[byte * 8 + bit];
+                    }
+                    byteKeys[location][byte][value] = key;
+                }
+            }
+        }
+        for (auto& key : lastCardKeys) key = splitMix(seed);
+        for (auto& key : trumpKeys) key = splitMix(seed);
+        for (auto& key : stateKeys) key = splitMix(seed);
+    }
+
+    uint64_t hashMask(int location, CardMask mask) const {
+        return byteKeys[location][0][mask & 0xFF] ^ byteKeys[location][1][(mask >> 8) & 0xFF] ^
+            byteKeys[location][2][(mask >> 16) & 0xFF] ^ byteKeys[location][3][mask >> 24];
+    }
+};
+
+// Fixed-size, always-replace transposition table that any number of threads
+// can share without locks. Each slot stores the entry data and key ^ data; a
+// slot torn by a concurrent write fails the key check and reads as a miss.
+class TranspositionTable {
+public:
+    enum Bound {
+        EXACT = 0,
+        LOWER = 1,
+        UPPER = 2
+    };
+
+    struct Entry {
+        int value;
+        Bound bound;
+        int bestMove;
+    };
+
+    explicit TranspositionTable(int log2Entries) : mask((size_t(1) << log2Entries) - 1),
+        slots(new Slot[size_t(1) << log2Entries]) {
+        clear();
+    }
+
+    static TranspositionTable& shared() {
+        static TranspositionTable table(18);
+        return table;
+    }
+
+    void clear() {
+        for (size_t i = 0; i <= mask; ++i) {
+            slots[i].check.store(0, std::memory_order_relaxed);
+            slots[i].data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    bool probe(uint64_t key, Entry& entry) const {
+        const Slot& slot = slots[key & mask];
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if ((check ^ data) != key || data == 0) return false;
+
+        entry.value = static_cast<int>(data & 0x3) - 1;
+        entry.bound = static_cast<Bound>((data >> 2) & 0x3);
+        entry.bestMove = static_cast<int>((data >> 4) & 0x1F);
+        return true;
+    }
+
+    void store(uint64_t key, int value, Bound bound, int bestMove) {
+        uint64_t data = static_cast<uint64_t>(value + 1) | (static_cast<uint64_t>(bound) << 2) |
+            (static_cast<uint64_t>(bestMove) << 4) | (uint64_t(1) << 9);
+        Slot& slot = slots[key & mask];
+        slot.data.store(data, std::memory_order_relaxed);
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+
+    size_t mask;
+    std::unique_ptr<Slot[]> slots;
+};
+
+// Exact alpha-beta solver for positions with an empty deck, where both hands
+// are known. Every move hands the turn to the other side, so this is plain
+// negamax over win (1), draw (0) and loss (-1). The game always terminates:
+// each move either discards cards or shrinks the attacker's hand.
+class EndgameSolver {
+public:
+    EndgameSolver(TranspositionTable& table, long long nodeLimit) : table(table), nodeLimit(nodeLimit), nodes(0) {}
+
+    // Returns false if the deck is not empty or the node limit ran out before
+    // the position was solved.
+    bool solve(const GamePosition& position, int& bestMove, int& value) {
+        nodes = 0;
+        aborted = false;
+        if (position.deckSize > 0 || position.isTerminal()) return false;
+
+        int side = position.sideToMove();
+        MoveMask moves = position.legalMoves();
+        bestMove = lowestCard(moves);
+        value = -2;
+
+        int alpha = -1;
+        for (; moves; moves &= moves - 1) {
+            int move = lowestCard(moves);
+            GamePosition child = position;
+            child.play(move);
+            int score = -negamax(child, 1 - side, -1, -alpha);
+            if (aborted) return false;
+
+            if (score > value) {
+                value = score;
+                bestMove = move;
+            }
+            if (score > alpha) alpha = score;
+            if (alpha == 1) break;
+        }
+        return true;
+    }
+
+    long long getNodes() const { return nodes; }
+
+private:
+    TranspositionTable& table;
+    long long nodeLimit;
+    long long nodes;
+    bool aborted = false;
+
+    // Transposition move first, then cheap plain cards before trumps and
+    // jokers; ending the move comes after the plain cards, taking comes last.
+    static int orderMoves(const GamePosition& position, int ttMove, int* moves) {
+        MoveMask legal = position.legalMoves();
+        int keys[MOVE_END + 1];
+        int numMoves = 0;
+
+        for (; legal; legal &= legal - 1) {
+            int move = lowestCard(legal);
+            int key;
+            if (move == MOVE_END) key = position.isDefending() ? 100 : 10;
+            else if (move >= 24) key = 60;
+            else if (move / CARDS_PER_SUIT == position.trumpSuit) key = 30 + move % CARDS_PER_SUIT;
+            else key = move % CARDS_PER_SUIT;
+            if (move == ttMove) key = -1;
+
+            int i = numMoves++;
+            for (; i > 0 && keys[i - 1] > key; --i) {
+                keys[i] = keys[i - 1];
+                moves[i] = moves[i - 1];
+            }
+            keys[i] = key;
+            moves[i] = move;
+        }
+        return numMoves;
+    }
+
+    int negamax(const GamePosition& position, int side, int alpha, int beta) {
+        if (position.isTerminal()) {
+            float result = position.result(side);
+            return result > 0.75f ? 1 : (result < 0.25f ? -1 : 0);
+        }
+        if (++nodes > nodeLimit) {
+            aborted = true;
+            return 0;
+        }
+
+        // Near the leaves a re-search is cheaper than a cache miss on the table.
+        bool useTable = cardCount(position.hands[SIDE_PLAYER] | position.hands[SIDE_COMPUTER]) > 5;
+        uint64_t key = useTable ? ZobristKeys::instance().hash(position) : 0;
+        TranspositionTable::Entry entry;
+        int ttMove = -1;
+        if (useTable && table.probe(key, entry)) {
+            if (entry.bound == TranspositionTable::EXACT) return entry.value;
+            if (entry.bound == TranspositionTable::LOWER && entry.value >= beta) return entry.value;
+            if (entry.bound == TranspositionTable::UPPER && entry.value <= alpha) return entry.value;
+            ttMove = entry.bestMove;
+        }
+
+        int originalAlpha = alpha;
+        int best = -2;
+        int bestMove = MOVE_END;
+
+        int moves[MOVE_END + 1];
+        int numMoves = orderMoves(position, ttMove, moves);
+
+        for (int i = 0; i < numMoves && alpha < beta; ++i) {
+            GamePosition child = position;
+            child.play(moves[i]);
+            int score = -negamax(child, 1 - side, -beta, -alpha);
+            if (aborted) return 0;
+
+            if (score > best) {
+                best = score;
+                bestMove = moves[i];
+            }
+            if (score > alpha) alpha = score;
+        }
+
+        TranspositionTable::Bound bound = TranspositionTable::EXACT;
+        if (best <= originalAlpha) bound = TranspositionTable::UPPER;
+        else if (best >= beta) bound = TranspositionTable::LOWER;
+        if (useTable) table.store(key, best, bound, bestMove);
+        return best;
+    }
+};
@@ -0,0 +1,109 @@
+#pragma once
+#include <glad/glad.h>
+#include <vector>
+#include <cstring>
+
+// Shadows the GL state the renderer sets every frame (the program, the VAO,
+// the texture on unit 0, the array buffer and mat4 uniforms per program) and
+// drops calls that would not change it. Anything that binds behind its back,
+// such as resource creation or texture uploads, must be followed by
+// invalidate(). Uniform locations are resolved once after linking and passed
+// in; counts of issued and skipped calls run until resetCounts().
+class GLStateCache {
+public:
+    void useProgram(GLuint program) {
+        if (program == boundProgram) {
+            ++skipped;
+            return;
+        }
+        glUseProgram(program);
+        boundProgram = program;
+        ++issued;
+    }
+
+    void bindVertexArray(GLuint vertexArray) {
+        if (vertexArray == boundVertexArray) {
+            ++skipped;
+            return;
+        }
+        glBindVertexArray(vertexArray);
+        boundVertexArray = vertexArray;
+        ++issued;
+    }
+
+    void bindTexture(GLuint texture) {
+        if (texture == boundTexture) {
+            ++skipped;
+            return;
+        }
+        glBindTexture(GL_TEXTURE_2D, texture);
+        boundTexture = texture;
+        ++issued;
+    }
+
+    void bindArrayBuffer(GLuint buffer) {
+        if (buffer == boundArrayBuffer) {
+            ++skipped;
+            return;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        boundArrayBuffer = buffer;
+        ++issued;
+    }
+
+    // Sets a mat4 uniform of the bound program.
+    void setUniformMatrix4(GLint location, const float* values) {
+        if (location < 0) return;
+
+        UniformMatrix* uniform = nullptr;
+        for (UniformMatrix& known : matrices) {
+            if (known.program == boundProgram && known.location == location) uniform = &known;
+        }
+        if (!uniform) {
+            matrices.push_back({ boundProgram, location, {} });
+            uniform = &matrices.back();
+        }
+        else if (std::memcmp(uniform->values, values, sizeof(uniform->values)) == 0) {
+            ++skipped;
+            return;
+        }
+
+        std::memcpy(uniform->values, values, sizeof(uniform->values));
+        glUniformMatrix4fv(location, 1, GL_FALSE, values);
+        ++issued;
+    }
+
+    // Forgets the bindings. Uniform values live in the program objects and
+    // stay valid.
+    void invalidate() {
+        boundProgram = UNKNOWN;
+        boundVertexArray = UNKNOWN;
+        boundTexture = UNKNOWN;
+        boundArrayBuffer = UNKNOWN;
+    }
+
+    int getIssued() const { return issued; }
+    int getSkipped() const { return skipped; }
+
+    void resetCounts() {
+        issued = 0;
+        skipped = 0;
+    }
+
+private:
+    static constexpr GLuint UNKNOWN = 0xFFFFFFFFu;
+
+    struct UniformMatrix {
+        GLuint program;
+        GLint location;
+        float values[16];
+    };
+
+    GLuint boundProgram = UNKNOWN;
+    GLuint boundVertexArray = UNKNOWN;
+    GLuint boundTexture = UNKNOWN;
+    GLuint boundArrayBuffer = UNKNOWN;
+    std::vector<UniformMatrix> matrices;
+    int issued = 0;
+    int skipped = 0;
+};
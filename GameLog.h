@@ -0,0 +1,170 @@
+#pragma once
+#include "GameLogic.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+// A whole game as its deal seed plus one byte per action: the action kind in
+// the top two bits and the card id in the low six. Replaying seeds a
+// GameLogic, deals, and pushes every action through apply(), the same
+// transitions the self-play engine uses, so a game replays bit-exactly
+// without running any AI.
+class GameLog {
+public:
+    enum Action {
+        ATTACK = 0,
+        DEFEND = 1,
+        TAKE = 2,
+        END_MOVE = 3
+    };
+
+    uint64_t seed = 0;
+    std::vector<uint8_t> actions;
+
+    static uint8_t encode(Action action, int cardId = 0) {
+        return static_cast<uint8_t>((action << 6) | (cardId & 0x3F));
+    }
+
+    static Action actionOf(uint8_t code) { return static_cast<Action>(code >> 6); }
+    static int cardOf(uint8_t code) { return code & 0x3F; }
+
+    void start(uint64_t gameSeed) {
+        seed = gameSeed;
+        actions.clear();
+    }
+
+    void record(uint8_t code) { actions.push_back(code); }
+
+    // Seeds and deals a new game exactly as it was dealt when recorded.
+    static void deal(GameLogic& gameLogic, uint64_t gameSeed) {
+        gameLogic.seed(gameSeed);
+        gameLogic.createFullDeck();
+        gameLogic.shuffleDeck();
+        gameLogic.firstdealCards();
+    }
+
+    // Plays one action for the side to move in `state` and returns the next
+    // state. An attack or defence the rules reject is turned into ending the
+    // move or taking the table, and `code` is rewritten to what happened.
+    static GameState apply(GameLogic& gameLogic, GameState state, uint8_t& code) {
+        Action action = actionOf(code);
+        int cardId = cardOf(code);
+
+        switch (state) {
+        case GameState::PLAYER_TURN_ATTACK:
+            if (action == ATTACK && gameLogic.playerAttack(handIndex(gameLogic.getPlayerHand(), cardId))) {
+                return GameState::COMPUTER_TURN_DEFEND;
+            }
+            code = encode(END_MOVE);
+            gameLogic.freetablecards();
+            gameLogic.dealCards();
+            return GameState::COMPUTER_TURN_ATTACK;
+        case GameState::PLAYER_TURN_DEFEND:
+            if (action == DEFEND &&
+                gameLogic.playerDefend(gameLogic.getTableSize() - 1, handIndex(gameLogic.getPlayerHand(), cardId))) {
+                return GameState::COMPUTER_TURN_ATTACK;
+            }
+            code = encode(TAKE);
+            gameLogic.playergettablecards();
+            gameLogic.dealCards();
+            return GameState::COMPUTER_TURN_ATTACK;
+        case GameState::COMPUTER_TURN_ATTACK:
+            if (action == ATTACK && gameLogic.computerAttack(handIndex(gameLogic.getComputerHand(), cardId))) {
+                return GameState::PLAYER_TURN_DEFEND;
+            }
+            code = encode(END_MOVE);
+            gameLogic.dealCards();
+            gameLogic.freetablecards();
+            return GameState::PLAYER_TURN_ATTACK;
+        case GameState::COMPUTER_TURN_DEFEND:
+            if (action != DEFEND || !gameLogic.computerDefend(handIndex(gameLogic.getComputerHand(), cardId))) {
+                code = encode(TAKE);
+                gameLogic.computergettablecards();
+                gameLogic.dealCards();
+            }
+            return GameState::PLAYER_TURN_ATTACK;
+        default:
+            return state;
+        }
+    }
+
+    // Replays the log into gameLogic. Returns false if an action no longer
+    // matches the rules (a corrupt log, or the rules changed).
+    bool replay(GameLogic& gameLogic) const {
+        deal(gameLogic, seed);
+        GameState state = GameState::PLAYER_TURN_ATTACK;
+        for (uint8_t recorded : actions) {
+            if (gameLogic.isGameOver()) return false;
+            uint8_t code = recorded;
+            state = apply(gameLogic, state, code);
+            if (code != recorded) return false;
+        }
+        return true;
+    }
+
+    // Batch file: "DLOG", version, game count, then per game the seed, the
+    // action count and the action bytes.
+    static bool save(const std::string& path, const std::vector<GameLog>& logs) {
+        std::ofstream file(path, std::ios::binary);
+        if (!file) return false;
+
+        uint32_t header[3] = { MAGIC, VERSION, static_cast<uint32_t>(logs.size()) };
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        for (const GameLog& log : logs) {
+            uint32_t count = static_cast<uint32_t>(log.actions.size());
+            file.write(reinterpret_cast<const char*>(&log.seed), sizeof(log.seed));
+            file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            file.write(reinterpret_cast<const char*>(log.actions.data()), count);
+        }
+        return static_cast<bool>(file);
+    }
+
+    // Every count is checked against the bytes left in the file before
+    // anything is sized from it, so a truncated or corrupt file fails
+    // instead of asking for gigabytes.
+    static bool load(const std::string& path, std::vector<GameLog>& logs) {
+        logs.clear();
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return false;
+        uint64_t remaining = static_cast<uint64_t>(file.tellg());
+        file.seekg(0);
+
+        uint32_t header[3];
+        if (remaining < sizeof(header) || !file.read(reinterpret_cast<char*>(header), sizeof(header))) return false;
+        remaining -= sizeof(header);
+        if (header[0] != MAGIC || header[1] != VERSION) return false;
+
+        const uint64_t gameHeaderSize = sizeof(uint64_t) + sizeof(uint32_t);
+        if (header[2] > remaining / gameHeaderSize) return false;
+        logs.resize(header[2]);
+        for (GameLog& log : logs) {
+            uint32_t count = 0;
+            if (!file.read(reinterpret_cast<char*>(&log.seed), sizeof(log.seed)) ||
+                !file.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+                return failLoad(logs);
+            }
+            remaining -= gameHeaderSize;
+            if (count > remaining) return failLoad(logs);
+
+            log.actions.resize(count);
+            if (!file.read(reinterpret_cast<char*>(log.actions.data()), count)) return failLoad(logs);
+            remaining -= count;
+        }
+        return true;
+    }
+
+private:
+    static constexpr uint32_t MAGIC = 0x474F4C44;  // "DLOG"
+    static constexpr uint32_t VERSION = 1;
+
+    static bool failLoad(std::vector<GameLog>& logs) {
+        logs.clear();
+        return false;
+    }
+
+    static int handIndex(CardMask hand, int cardId) {
+        if (cardId >= CARD_COUNT || !(hand & cardBit(cardId))) return -1;
+        return indexOfCard(hand, cardId);
+    }
+};
@@ -0,0 +1,709 @@
+#pragma once
+#include "Card.h"
+#include "CardMask.h"
+#include "BeatTable.h"
+#include "GamePosition.h"
+#include "AttackMoves.h"
+#include "AIWeights.h"
+#include "CardTracker.h"
+#include "AIWorkerPool.h"
+#include "ISMCTS.h"
+#include "EndgameSolver.h"
+#include <vector>
+#include <string>
+#include <random>
+#include <mutex>
+#include <memory>
+#include <algorithm>
+#include <climits>
+
+// SplitMix64: a 64-bit seed fully determines the stream, and reseeding for
+// every recorded game costs one store instead of refilling an mt19937 state.
+class DealRandom {
+public:
+    typedef uint64_t result_type;
+
+    explicit DealRandom(uint64_t seed = 0) : state(seed) {}
+
+    void seed(uint64_t value) { state = value; }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    result_type operator()() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t state;
+};
+
+enum class AIMode {
+    HEURISTIC = 0,
+    ISMCTS = 1
+};
+
+// Node cap for the endgame solver. At roughly 100 ns a node a capped solve
+// takes about half a millisecond (p99 0.6 ms over 300 self-play games), so
+// even a search that gives up and falls back to the heuristic stays well
+// inside a 60 Hz frame.
+const long long ENDGAME_NODE_LIMIT = 5000;
+
+// Fewest attack sets worth scoring on the AI pool. A set scores in about
+// 15 ns, while a pool round trip costs about 3.5 us (cardgame_benchmark:
+// 3756 ns for an attack on 4 threads against 130 ns inline), so with 4
+// threads the pool only wins above roughly 300 sets. A hand yields at most
+// MAX_ATTACK_MOVES, so today every heuristic move is scored inline.
+const int AI_POOL_MIN_ATTACK_MOVES = 320;
+
+class GameLogic {
+private:
+    DealRandom rng;
+    int deck[CARD_COUNT];
+    int deckSize;
+    CardMask playerHand;
+    CardMask computerHand;
+    CardMask tableMask;
+    CardMask discardMask;
+    int table[CARD_COUNT];
+    int tableSize;
+    int trumpId;
+    int trumpSuit;
+    const CardMask* beatingCards;
+    std::mutex aiMutex;
+    std::unique_ptr<AIWorkerPool> aiPool;
+    AIMode aiMode;
+    ISMCTSConfig ismctsConfig;
+    bool endgameSolverEnabled;
+    long long endgameNodeLimit;
+    unsigned int revision;
+    // Rest of the attack set each side's heuristic AI chose; it is thrown in
+    // one card per attack turn while the trick lasts.
+    CardMask attackPlan;
+    CardMask playerAttackPlan;
+    AIWeights weights;
+    AIWeights playerWeights;
+    CardTracker tracker;
+
+    // What every defence evaluation needs to know about the hand, worked out
+    // once per decision instead of once per candidate card.
+    struct DefenseFacts {
+        int attackId;
+        CardMask candidates;        // cards in hand that beat attackId
+        bool nonTrumpAlternative;   // some candidate is not a trump
+    };
+
+    // Hand indices of candidate moves; fixed capacity, so a decision never
+    // touches the heap.
+    struct MoveList {
+        int moves[CARD_COUNT];
+        int count = 0;
+
+        void push(int move) { moves[count++] = move; }
+    };
+
+    struct AIJob {
+        GameLogic* logic;
+        const AttackMoveList* moves;
+        CardMask opponentMay;
+        int startIdx;
+        int endIdx;
+        int result;
+    };
+
+    DefenseFacts getDefenseFacts() const {
+        DefenseFacts facts;
+        facts.attackId = table[tableSize - 1];
+        facts.candidates = computerHand & getBeatingCards(facts.attackId);
+        facts.nonTrumpAlternative = (facts.candidates & ~suitMask(trumpSuit)) != 0;
+        return facts;
+    }
+
+    int calculateSimpleAIMove(bool isAttackTurn) {
+        if (isAttackTurn) {
+            return findBestAttackCard();
+        }
+        if (tableSize == 0) return -1;
+
+        // The cheapest beater and the strategically best one.
+        DefenseFacts facts = getDefenseFacts();
+        MoveList candidates;
+        int minimal = findMinimalDefenseCard(facts);
+        int strategic = findStrategicDefenseCard(facts);
+        if (minimal != -1) candidates.push(minimal);
+        if (strategic != -1) candidates.push(strategic);
+        return selectBestDefense(candidates, facts);
+    }
+
+    void ensureAIPool(int numThreads) {
+        if (!aiPool || aiPool->size() < numThreads - 1) {
+            aiPool.reset(new AIWorkerPool(numThreads - 1));
+        }
+    }
+
+    // With the deck gone every card is accounted for: whatever is not in the
+    // computer's hand, on the table, discarded or the trump is the player's hand.
+    bool calculateEndgameMove(bool isAttackTurn, int& cardIndex) {
+        CardMask trumpBit = trumpId == -1 ? 0 : cardBit(trumpId);
+        GamePosition position = getPosition(isAttackTurn);
+        position.hands[SIDE_PLAYER] = FULL_DECK_MASK & ~(computerHand | tableMask | discardMask | trumpBit);
+
+        EndgameSolver solver(TranspositionTable::shared(), endgameNodeLimit);
+        int move, value;
+        if (!solver.solve(position, move, value)) return false;
+
+        cardIndex = move == MOVE_END ? -1 : indexOfCard(computerHand, move);
+        return true;
+    }
+
+    int calculateISMCTSMove(bool isAttackTurn, int numThreads) {
+        if (numThreads > 1) {
+            ensureAIPool(numThreads);
+        }
+
+        CardMask trumpBit = trumpId == -1 ? 0 : cardBit(trumpId);
+        HiddenCards hidden;
+        hidden.unknown = FULL_DECK_MASK & ~(computerHand | tableMask | discardMask | trumpBit);
+        hidden.opponentHas = tracker.definitelyHeld(SIDE_PLAYER);
+        hidden.opponentLacks = tracker.ruledOut(SIDE_PLAYER);
+
+        int move = ISMCTS::search(getPosition(isAttackTurn), hidden, ismctsConfig,
+            numThreads > 1 ? aiPool.get() : nullptr, numThreads, static_cast<unsigned int>(rng()));
+        if (move == MOVE_END) return -1;
+        return indexOfCard(computerHand, move);
+    }
+
+    // Scores the attack sets on the pool, split into one range per thread,
+    // once there are enough of them to pay for the hand-off.
+    int calculateMultiThreadAttack(int numThreads) {
+        CardMask planned = plannedAttackCards();
+        if (planned) return indexOfCard(computerHand, firstAttackCard(planned));
+
+        AttackMoveList moves;
+        generateAttackMoves(computerHand, tableMask, maxAttackCards(), moves);
+        CardMask opponentMay = opponentMayHold();
+        if (moves.count < AI_POOL_MIN_ATTACK_MOVES) {
+            int best = findBestAttackSetInRange(moves, 0, moves.count, opponentMay);
+            return commitAttackSet(best == -1 ? ATTACK_END : moves.moves[best]);
+        }
+
+        ensureAIPool(numThreads);
+        AIJob jobs[CARD_COUNT];
+        int numJobs = 0;
+        AIWorkerPool::TaskGroup group;
+        int movesPerThread = std::max(1, (moves.count + numThreads - 1) / numThreads);
+
+        for (int i = 0; i < numThreads; ++i) {
+            int startIdx = i * movesPerThread;
+            int endIdx = std::min((i + 1) * movesPerThread, moves.count);
+
+            if (startIdx >= endIdx) break;
+
+            jobs[numJobs] = { this, &moves, opponentMay, startIdx, endIdx, -1 };
+            aiPool->submit(group, [](void* context) {
+                AIJob* job = static_cast<AIJob*>(context);
+                job->result = job->logic->findBestAttackSetInRange(*job->moves, job->startIdx, job->endIdx, job->opponentMay);
+                }, &jobs[numJobs]);
+            ++numJobs;
+        }
+
+        aiPool->wait(group);
+
+        int best = -1;
+        int bestScore = INT_MIN;
+        for (int i = 0; i < numJobs; ++i) {
+            if (jobs[i].result == -1) continue;
+            int score = evaluateAttackSet(moves.moves[jobs[i].result], opponentMay);
+            if (score > bestScore) {
+                bestScore = score;
+                best = jobs[i].result;
+            }
+        }
+        return commitAttackSet(best == -1 ? ATTACK_END : moves.moves[best]);
+    }
+
+    // Continues the planned attack set while the trick lasts; otherwise
+    // chooses a new set, plays its first card and plans the rest.
+    int findBestAttackCard() {
+        CardMask planned = plannedAttackCards();
+        if (planned) return indexOfCard(computerHand, firstAttackCard(planned));
+
+        AttackMoveList moves;
+        generateAttackMoves(computerHand, tableMask, maxAttackCards(), moves);
+        int best = findBestAttackSetInRange(moves, 0, moves.count, opponentMayHold());
+        return commitAttackSet(best == -1 ? ATTACK_END : moves.moves[best]);
+    }
+
+    // Index into moves of the best set in [startIdx, endIdx), or -1. END is
+    // only ever the fallback, as the AI throws in whenever it can.
+    int findBestAttackSetInRange(const AttackMoveList& moves, int startIdx, int endIdx, CardMask opponentMay) const {
+        int best = -1;
+        int bestScore = INT_MIN;
+
+        for (int i = startIdx; i < endIdx; ++i) {
+            if (moves.moves[i] == ATTACK_END) continue;
+            int score = evaluateAttackSet(moves.moves[i], opponentMay);
+            if (score > bestScore) {
+                bestScore = score;
+                best = i;
+            }
+        }
+
+        return best;
+    }
+
+    // Every card the player may hold, as far as the computer can tell.
+    CardMask opponentMayHold() const {
+        return tracker.possiblyHeld(SIDE_PLAYER, computerHand, tableMask);
+    }
+
+    // The defender has to answer every card, so a set is capped by their hand.
+    int maxAttackCards() const {
+        return std::max(1, std::min(MAX_ATTACK_CARDS, cardCount(playerHand)));
+    }
+
+    CardMask plannedAttackCards() const {
+        if (tableMask == 0) return 0;
+        return attackPlan & computerHand & sameRankMask(tableMask);
+    }
+
+    // Non-trumps go first, so the trumps of a set are the last to be committed.
+    int firstAttackCard(AttackMove set) const {
+        CardMask nonTrumps = set & ~suitMask(trumpSuit);
+        return lowestCard(nonTrumps ? nonTrumps : set);
+    }
+
+    int commitAttackSet(AttackMove set) {
+        if (set == ATTACK_END) {
+            attackPlan = 0;
+            return -1;
+        }
+        int cardId = firstAttackCard(set);
+        attackPlan = set & ~cardBit(cardId);
+        return indexOfCard(computerHand, cardId);
+    }
+
+    int findMinimalDefenseCard(const DefenseFacts& facts) {
+        int bestCardIndex = -1;
+        int minValue = INT_MAX;
+
+        for (CardMask candidates = facts.candidates; candidates; candidates &= candidates - 1) {
+            int cardId = lowestCard(candidates);
+            int value = getCardValue(cardId);
+            if (value < minValue) {
+                minValue = value;
+                bestCardIndex = indexOfCard(computerHand, cardId);
+            }
+        }
+
+        return bestCardIndex;
+    }
+
+    int findStrategicDefenseCard(const DefenseFacts& facts) {
+        int bestCardIndex = -1;
+        int bestScore = INT_MIN;
+
+        for (CardMask candidates = facts.candidates; candidates; candidates &= candidates - 1) {
+            int cardId = lowestCard(candidates);
+            int score = evaluateStrategicDefense(cardId, facts);
+            if (score > bestScore) {
+                bestScore = score;
+                bestCardIndex = indexOfCard(computerHand, cardId);
+            }
+        }
+
+        return bestCardIndex;
+    }
+
+    // A take only suggests the defender had no beater (it may have kept one
+    // back), so beaters ruled out that way earn half the unanswerable bonus.
+    int evaluateAttackCard(int cardId, CardMask opponentMay) const {
+        int score = getCardValue(cardId) * weights[AIWeights::ATTACK_VALUE];
+
+        CardMask beaters = getBeatingCards(cardId) & opponentMay;
+        if (beaters == 0) {
+            score += weights[AIWeights::ATTACK_UNANSWERABLE];
+        }
+        else if ((beaters & ~tracker.ruledOut(SIDE_PLAYER)) == 0) {
+            score += weights[AIWeights::ATTACK_UNANSWERABLE] / 2;
+        }
+
+        if (Card::suitOf(cardId) != trumpSuit) {
+            score += weights[AIWeights::ATTACK_NON_TRUMP];
+        }
+        else {
+            score += weights[AIWeights::ATTACK_TRUMP];
+        }
+
+        return score;
+    }
+
+    // Every card of the set shed is scored as a single attack would be.
+    int evaluateAttackSet(AttackMove set, CardMask opponentMay) const {
+        int score = 0;
+        for (; set; set &= set - 1) {
+            score += evaluateAttackCard(lowestCard(set), opponentMay);
+        }
+        return score;
+    }
+
+    int evaluateDefenseCard(int cardId, const DefenseFacts& facts) const {
+        int score = getCardValue(cardId) * weights[AIWeights::DEFENSE_VALUE];
+
+        if (Card::suitOf(cardId) == trumpSuit) {
+            score += facts.nonTrumpAlternative ? weights[AIWeights::DEFENSE_TRUMP_WITH_ALTERNATIVE]
+                : weights[AIWeights::DEFENSE_TRUMP_FORCED];
+        }
+
+        if (getCardValue(cardId) > 10) {
+            score += weights[AIWeights::DEFENSE_HIGH_CARD];
+        }
+
+        return score;
+    }
+
+    int evaluateStrategicDefense(int cardId, const DefenseFacts& facts) const {
+        int score = getCardValue(cardId) * weights[AIWeights::STRATEGIC_VALUE];
+
+        if (Card::suitOf(cardId) == trumpSuit && facts.nonTrumpAlternative) {
+            score += weights[AIWeights::STRATEGIC_TRUMP_WITH_ALTERNATIVE];
+        }
+
+        if (Card::suitOf(cardId) == Card::suitOf(facts.attackId)) {
+            score += weights[AIWeights::STRATEGIC_SAME_SUIT];
+        }
+
+        return score;
+    }
+
+    int selectBestDefense(const MoveList& candidates, const DefenseFacts& facts) const {
+        if (candidates.count == 0) return -1;
+        if (candidates.count == 1) return candidates.moves[0];
+
+        int bestIndex = candidates.moves[0];
+        int bestScore = evaluateDefenseCard(cardAtIndex(computerHand, bestIndex), facts);
+
+        for (int i = 1; i < candidates.count; ++i) {
+            int score = evaluateDefenseCard(cardAtIndex(computerHand, candidates.moves[i]), facts);
+            if (score > bestScore) {
+                bestScore = score;
+                bestIndex = candidates.moves[i];
+            }
+        }
+
+        return bestIndex;
+    }
+
+    int drawCard() {
+        return deck[--deckSize];
+    }
+
+    // What beats the attack card the defender faces; the table alternates
+    // attack and defence cards, so an odd count means one is unanswered.
+    CardMask undefendedBeaters() const {
+        return tableSize % 2 == 1 ? getBeatingCards(table[tableSize - 1]) : 0;
+    }
+
+public:
+    GameLogic() : rng((static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}()), deckSize(0), playerHand(0),
+        computerHand(0), tableMask(0), discardMask(0), tableSize(0), trumpId(-1), trumpSuit(-1),
+        beatingCards(BEAT_TABLE.beatingCards[NO_TRUMP]), aiMutex(), aiMode(AIMode::HEURISTIC),
+        endgameSolverEnabled(true), endgameNodeLimit(ENDGAME_NODE_LIMIT), revision(0), attackPlan(0), playerAttackPlan(0) {
+    }
+
+    // Makes shuffles, deals and AI playouts reproducible from here on.
+    void seed(uint64_t value) {
+        rng.seed(value);
+    }
+
+    void createFullDeck() {
+        deckSize = 0;
+        for (int id = 0; id < CARD_COUNT; ++id) {
+            deck[deckSize++] = id;
+        }
+        ++revision;
+    }
+
+    void shuffleDeck() {
+        std::shuffle(deck, deck + deckSize, rng);
+        ++revision;
+    }
+
+    void firstdealCards() {
+        ++revision;
+        tracker.reset();
+        playerHand = 0;
+        computerHand = 0;
+        tableMask = 0;
+        tableSize = 0;
+        discardMask = 0;
+
+        for (int i = 0; i < 6; ++i) {
+            if (deckSize > 0) {
+                playerHand |= cardBit(drawCard());
+            }
+            if (deckSize > 0) {
+                computerHand |= cardBit(drawCard());
+            }
+        }
+
+        if (deckSize > 0) {
+            while (Card::rankOf(deck[deckSize - 1]) == Card::JOKER_RANK)
+                shuffleDeck();
+            setTrumpCard(drawCard());
+        }
+    }
+
+    void dealCards() {
+        ++revision;
+        int playerCount = cardCount(playerHand);
+        int computerCount = cardCount(computerHand);
+        while (cardCount(playerHand) < 6 && cardCount(computerHand) < 6 && deckSize > 0) {
+            playerHand |= cardBit(drawCard());
+            if (deckSize == 0) break;
+            computerHand |= cardBit(drawCard());
+        }
+
+        while (cardCount(playerHand) < 6 && deckSize > 0) {
+            playerHand |= cardBit(drawCard());
+        }
+
+        while (cardCount(computerHand) < 6 && deckSize > 0) {
+            computerHand |= cardBit(drawCard());
+        }
+
+        if (cardCount(playerHand) != playerCount) tracker.onDraw(SIDE_PLAYER);
+        if (cardCount(computerHand) != computerCount) tracker.onDraw(SIDE_COMPUTER);
+    }
+
+    // Every card that beats attackId under the current trump.
+    CardMask getBeatingCards(int attackId) const {
+        return beatingCards[attackId];
+    }
+
+    bool canBeatCard(int attackId, int defendId) const {
+        return (getBeatingCards(attackId) & cardBit(defendId)) != 0;
+    }
+
+    int getCardValue(int cardId) const {
+        switch (Card::rankOf(cardId)) {
+        case Card::TWO: return 2;
+        case Card::TEN: return 10;
+        case Card::JACK: return 11;
+        case Card::QUEEN: return 12;
+        case Card::KING: return 13;
+        case Card::ACE: return 14;
+        case Card::JOKER_RANK: return 100;
+        default: return 1;
+        }
+    }
+
+    bool playerAttack(int cardIndex) {
+        int cardId = cardAtIndex(playerHand, cardIndex);
+        if (cardIndex < 0 || cardId == -1) {
+            return false;
+        }
+
+        if (canAttackWithCard(cardId)) {
+            playerHand &= ~cardBit(cardId);
+            tracker.onPlay(SIDE_PLAYER, cardId);
+            putOnTable(cardId);
+            return true;
+        }
+
+        return false;
+    }
+
+    bool canAttackWithCard(int cardId) const {
+        if (tableMask == 0) return true;
+        return (tableMask & rankMask(Card::rankOf(cardId))) != 0;
+    }
+
+    bool playerDefend(int attackCardIndex, int defendCardIndex) {
+        int defendId = defendCardIndex < 0 ? -1 : cardAtIndex(playerHand, defendCardIndex);
+        if (attackCardIndex < 0 || attackCardIndex >= tableSize || defendId == -1) {
+            return false;
+        }
+
+        if (canBeatCard(table[attackCardIndex], defendId)) {
+            playerHand &= ~cardBit(defendId);
+            tracker.onPlay(SIDE_PLAYER, defendId);
+            putOnTable(defendId);
+            return true;
+        }
+
+        return false;
+    }
+
+    bool computerAttack(int cardIndex) {
+        int cardId = cardIndex < 0 ? -1 : cardAtIndex(computerHand, cardIndex);
+        if (cardId == -1) {
+            return false;
+        }
+
+        computerHand &= ~cardBit(cardId);
+        tracker.onPlay(SIDE_COMPUTER, cardId);
+        putOnTable(cardId);
+        return true;
+    }
+
+    bool computerDefend(int cardIndex) {
+        int cardId = cardIndex < 0 ? -1 : cardAtIndex(computerHand, cardIndex);
+        if (tableSize == 0 || cardId == -1) {
+            return false;
+        }
+
+        computerHand &= ~cardBit(cardId);
+        tracker.onPlay(SIDE_COMPUTER, cardId);
+        putOnTable(cardId);
+        return true;
+    }
+
+    void putOnTable(int cardId) {
+        table[tableSize++] = cardId;
+        tableMask |= cardBit(cardId);
+        ++revision;
+    }
+
+    bool isGameOver() {
+        return playerHand == 0 || computerHand == 0;
+    }
+
+    std::string getWinner() {
+
+        if (playerHand == 0 && computerHand == 0) {
+            return "draw!";
+        }
+        else if (playerHand == 0) {
+            return "Player wins!";
+        }
+        else if (computerHand == 0) {
+            return "Computer wins!";
+        }
+
+        return "Continue game";
+    }
+
+    int calculateAIMove(bool isAttackTurn, int numThreads = 2) {
+        if (computerHand == 0) return -1;
+
+        int endgameMove;
+        if (endgameSolverEnabled && deckSize == 0 && trumpId != -1 && calculateEndgameMove(isAttackTurn, endgameMove)) {
+            return endgameMove;
+        }
+
+        if (aiMode == AIMode::ISMCTS) {
+            return calculateISMCTSMove(isAttackTurn, numThreads);
+        }
+
+        // Defence weighs just two candidates, far too little to hand to the pool.
+        if (!isAttackTurn || numThreads <= 1 || cardCount(computerHand) <= 2) {
+            return calculateSimpleAIMove(isAttackTurn);
+        }
+
+        return calculateMultiThreadAttack(numThreads);
+    }
+
+    // Same AI, but playing the player's hand (used by headless self-play).
+    int calculatePlayerAIMove(bool isAttackTurn, int numThreads = 2) {
+        std::swap(playerHand, computerHand);
+        std::swap(playerAttackPlan, attackPlan);
+        std::swap(playerWeights, weights);
+        tracker.swapSides();
+        int cardIndex = calculateAIMove(isAttackTurn, numThreads);
+        tracker.swapSides();
+        std::swap(playerWeights, weights);
+        std::swap(playerAttackPlan, attackPlan);
+        std::swap(playerHand, computerHand);
+        return cardIndex;
+    }
+
+    void computergettablecards() {
+        tracker.onTake(SIDE_COMPUTER, tableMask, undefendedBeaters());
+        computerHand |= tableMask;
+        tableMask = 0;
+        tableSize = 0;
+        attackPlan = 0;
+        playerAttackPlan = 0;
+        ++revision;
+    }
+
+    void playergettablecards() {
+        tracker.onTake(SIDE_PLAYER, tableMask, undefendedBeaters());
+        playerHand |= tableMask;
+        tableMask = 0;
+        tableSize = 0;
+        attackPlan = 0;
+        playerAttackPlan = 0;
+        ++revision;
+    }
+
+    void freetablecards() {
+        tracker.onDiscard(tableMask);
+        discardMask |= tableMask;
+        tableMask = 0;
+        tableSize = 0;
+        attackPlan = 0;
+        playerAttackPlan = 0;
+        ++revision;
+    }
+
+    // The deal as seen by the computer, which is about to attack or defend.
+    GamePosition getPosition(bool isAttackTurn) const {
+        GamePosition position;
+        position.hands[SIDE_PLAYER] = playerHand;
+        position.hands[SIDE_COMPUTER] = computerHand;
+        position.tableMask = tableMask;
+        position.lastTableCard = tableSize > 0 ? table[tableSize - 1] : -1;
+        std::copy(deck, deck + deckSize, position.deck);
+        position.deckSize = deckSize;
+        position.trumpSuit = trumpSuit < NO_TRUMP && trumpSuit >= 0 ? trumpSuit : NO_TRUMP;
+        position.state = isAttackTurn ? GameState::COMPUTER_TURN_ATTACK : GameState::COMPUTER_TURN_DEFEND;
+        return position;
+    }
+
+    void setAIMode(AIMode mode) { aiMode = mode; }
+    void setAIWeights(const AIWeights& computer) { weights = computer; }
+    void setPlayerAIWeights(const AIWeights& player) { playerWeights = player; }
+    const AIWeights& getAIWeights() const { return weights; }
+    void setISMCTSConfig(const ISMCTSConfig& config) { ismctsConfig = config; }
+    void setEndgameSolver(bool enabled, long long nodeLimit = ENDGAME_NODE_LIMIT) {
+        endgameSolverEnabled = enabled;
+        endgameNodeLimit = nodeLimit;
+    }
+
+    Card getTrumpCard() const { return trumpId == -1 ? Card() : Card::fromId(trumpId); }
+    int getTrumpId() const { return trumpId; }
+    const int* getTable() const { return table; }
+
+    CardMask getPlayerHand() const { return playerHand; }
+    CardMask getComputerHand() const { return computerHand; }
+    CardMask getTableMask() const { return tableMask; }
+    CardMask getDiscardMask() const { return discardMask; }
+    int getTableSize() const { return tableSize; }
+    int getDeckSize() const { return deckSize; }
+    int getTrumpSuit() const { return trumpSuit; }
+
+    // Bumped by every change to the hands, table, deck or trump, so the
+    // renderer can tell whether anything visible changed since it last drew.
+    unsigned int getRevision() const { return revision; }
+
+    // The AI worker pool, or nullptr until a multi-threaded search created it.
+    const AIWorkerPool* getAIPool() const { return aiPool.get(); }
+
+    const CardTracker& getTracker() const { return tracker; }
+
+    void setPlayerHand(CardMask hand) { playerHand = hand; ++revision; }
+    void setComputerHand(CardMask hand) { computerHand = hand; ++revision; }
+    void setTrumpCard(int cardId) {
+        ++revision;
+        trumpId = cardId;
+        trumpSuit = Card::suitOf(cardId);
+        tracker.onTrump(cardId);
+        beatingCards = BEAT_TABLE.beatingCards[trumpSuit < NO_TRUMP ? trumpSuit : NO_TRUMP];
+    }
+
+};
@@ -0,0 +1,120 @@
+#pragma once
+#include "CardMask.h"
+#include "BeatTable.h"
+
+enum class GameState {
+    START_GAME = 0,
+    PLAYER_TURN_ATTACK = 1,
+    PLAYER_TURN_DEFEND = 2,
+    COMPUTER_TURN_ATTACK = 3,
+    COMPUTER_TURN_DEFEND = 4,
+    GAME_OVER = 5,
+    LOADING = 6
+};
+
+const int SIDE_PLAYER = 0;
+const int SIDE_COMPUTER = 1;
+
+// A move is a card id, or MOVE_END: stop attacking, or take the table when defending.
+const int MOVE_END = CARD_COUNT;
+
+// Legal moves as a card mask with the extra MOVE_END bit.
+typedef uint32_t MoveMask;
+
+// Self-contained copy of a deal, cheap enough to clone for every search
+// playout. Transitions follow Game::update: after a successful defense or a
+// take the attacker attacks again, after the attacker ends the move the
+// defender becomes the attacker.
+struct GamePosition {
+    CardMask hands[2];
+    CardMask tableMask;
+    int lastTableCard;
+    int deck[CARD_COUNT];
+    int deckSize;
+    int trumpSuit;
+    GameState state;
+
+    static GameState attackState(int side) {
+        return side == SIDE_PLAYER ? GameState::PLAYER_TURN_ATTACK : GameState::COMPUTER_TURN_ATTACK;
+    }
+
+    static GameState defendState(int side) {
+        return side == SIDE_PLAYER ? GameState::PLAYER_TURN_DEFEND : GameState::COMPUTER_TURN_DEFEND;
+    }
+
+    int sideToMove() const {
+        return state == GameState::PLAYER_TURN_ATTACK || state == GameState::PLAYER_TURN_DEFEND ? SIDE_PLAYER : SIDE_COMPUTER;
+    }
+
+    bool isDefending() const {
+        return state == GameState::PLAYER_TURN_DEFEND || state == GameState::COMPUTER_TURN_DEFEND;
+    }
+
+    bool isTerminal() const {
+        return hands[SIDE_PLAYER] == 0 || hands[SIDE_COMPUTER] == 0;
+    }
+
+    // 1 for a win, 0.5 for a draw, 0 for a loss (only meaningful when terminal).
+    float result(int side) const {
+        if (hands[SIDE_PLAYER] == 0 && hands[SIDE_COMPUTER] == 0) return 0.5f;
+        return hands[side] == 0 ? 1.0f : 0.0f;
+    }
+
+    MoveMask legalMoves() const {
+        CardMask hand = hands[sideToMove()];
+
+        if (isDefending()) {
+            CardMask beaters = BEAT_TABLE.beatingCards[trumpSuit][lastTableCard];
+            return (hand & beaters) | cardBit(MOVE_END);
+        }
+
+        if (tableMask == 0) {
+            return hand;
+        }
+
+        return (hand & sameRankMask(tableMask)) | cardBit(MOVE_END);
+    }
+
+    void play(int move) {
+        int side = sideToMove();
+        int other = 1 - side;
+
+        if (move != MOVE_END) {
+            hands[side] &= ~cardBit(move);
+            tableMask |= cardBit(move);
+            lastTableCard = move;
+            state = isDefending() ? attackState(other) : defendState(other);
+        }
+        else if (isDefending()) {
+            hands[side] |= tableMask;
+            tableMask = 0;
+            dealCards();
+            state = attackState(other);
+        }
+        else {
+            tableMask = 0;
+            dealCards();
+            state = attackState(other);
+        }
+
+        if (isTerminal()) {
+            state = GameState::GAME_OVER;
+        }
+    }
+
+    void dealCards() {
+        while (cardCount(hands[SIDE_PLAYER]) < 6 && cardCount(hands[SIDE_COMPUTER]) < 6 && deckSize > 0) {
+            hands[SIDE_PLAYER] |= cardBit(deck[--deckSize]);
+            if (deckSize == 0) break;
+            hands[SIDE_COMPUTER] |= cardBit(deck[--deckSize]);
+        }
+
+        while (cardCount(hands[SIDE_PLAYER]) < 6 && deckSize > 0) {
+            hands[SIDE_PLAYER] |= cardBit(deck[--deckSize]);
+        }
+
+        while (cardCount(hands[SIDE_COMPUTER]) < 6 && deckSize > 0) {
+            hands[SIDE_COMPUTER] |= cardBit(deck[--deckSize]);
+        }
+    }
+};
@@ -0,0 +1,134 @@
+#pragma once
+#include "TableLayout.h"
+#include <vector>
+#include <algorithm>
+
+struct HitResult {
+    int zone;   // TableLayout::ZONE_PLAYER_HAND, HitGrid::ZONE_END_ATTACK, HitGrid::ZONE_TAKE, or -1 for nothing
+    int index;  // position within the zone
+};
+
+// Uniform grid over every interactive region of the table: the cards of the
+// player's hand plus the two corner buttons. The other cards take no clicks
+// and are left out, so they never cover a button. Each cell lists the
+// regions that touch it, so a click or hover query checks a handful of
+// rectangles whatever the hand size. When regions overlap, the one drawn last
+// wins; the corner buttons lie under the hand.
+class HitGrid {
+public:
+    static constexpr int ZONE_END_ATTACK = TableLayout::ZONE_COUNT;      // bottom-left corner
+    static constexpr int ZONE_TAKE = TableLayout::ZONE_COUNT + 1;        // top-right corner
+    static constexpr float CELL_SIZE = 64.0f;
+    static constexpr float BUTTON_SIZE = 100.0f;
+
+    HitGrid(float width, float height) : width(width), height(height),
+        columns(static_cast<int>(width / CELL_SIZE) + 1), rows(static_cast<int>(height / CELL_SIZE) + 1),
+        cellStart(columns * rows + 1, 0) {}
+
+    void build(const TableLayout& layout) {
+        regions.clear();
+        liftedRegion = -1;
+        addRegion(ZONE_END_ATTACK, 0, 0.0f, 0.0f, BUTTON_SIZE, BUTTON_SIZE);
+        addRegion(ZONE_TAKE, 0, width - BUTTON_SIZE, height - BUTTON_SIZE, width, height);
+
+        const float* xs = layout.xs();
+        const float* ys = layout.ys();
+        handBegin = layout.zoneBegin(TableLayout::ZONE_PLAYER_HAND);
+        handEnd = layout.zoneEnd(TableLayout::ZONE_PLAYER_HAND);
+        for (int i = handBegin; i < handEnd; ++i) {
+            addRegion(TableLayout::ZONE_PLAYER_HAND, i - handBegin, xs[i], ys[i], xs[i] + layout.getCardWidth(),
+                ys[i] + layout.getCardHeight());
+        }
+
+        // Counting sort of region ids into cells; regions stay in draw order within a cell.
+        std::fill(cellStart.begin(), cellStart.end(), 0);
+        for (const Region& region : regions) {
+            forEachCell(region, [this](int cell) { cellStart[cell + 1]++; });
+        }
+        for (size_t cell = 1; cell < cellStart.size(); ++cell) {
+            cellStart[cell] += cellStart[cell - 1];
+        }
+        cellItems.resize(cellStart.back());
+        fillPosition.assign(cellStart.begin(), cellStart.end() - 1);
+        for (int id = 0; id < static_cast<int>(regions.size()); ++id) {
+            forEachCell(regions[id], [this, id](int cell) { cellItems[fillPosition[cell]++] = id; });
+        }
+    }
+
+    // Matches a card drawn raised by `lift` (a layout index, or -1 for none):
+    // its hit rect reaches up by the same amount and keeps its resting bottom,
+    // so the card stays hovered while the cursor is in the strip it left.
+    void setLifted(int layoutIndex, float lift) {
+        liftedRegion = layoutIndex >= handBegin && layoutIndex < handEnd ? BUTTON_COUNT + layoutIndex - handBegin : -1;
+        liftHeight = lift;
+    }
+
+    // Point in GL window coordinates (origin at the bottom-left).
+    HitResult query(float x, float y) const {
+        HitResult hit = { -1, -1 };
+        if (x < 0.0f || y < 0.0f || x > width || y > height) return hit;
+
+        int cell = cellIndex(x, y);
+        int best = -1;
+        for (int i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+            const Region& region = regions[cellItems[i]];
+            if (x >= region.x0 && x <= region.x1 && y >= region.y0 && y <= region.y1) {
+                best = cellItems[i];
+            }
+        }
+        if (liftedRegion > best && liftedRegion < static_cast<int>(regions.size())) {
+            const Region& region = regions[liftedRegion];
+            if (x >= region.x0 && x <= region.x1 && y >= region.y0 && y <= region.y1 + liftHeight) {
+                best = liftedRegion;
+            }
+        }
+        if (best != -1) {
+            hit.zone = regions[best].zone;
+            hit.index = regions[best].index;
+        }
+        return hit;
+    }
+
+private:
+    static constexpr int BUTTON_COUNT = 2;  // regions added before the hand
+
+    struct Region {
+        float x0, y0, x1, y1;
+        int zone;
+        int index;
+    };
+
+    float width;
+    float height;
+    int columns;
+    int rows;
+    std::vector<Region> regions;
+    std::vector<int> cellStart;
+    std::vector<int> cellItems;
+    std::vector<int> fillPosition;
+    int handBegin = 0;
+    int handEnd = 0;
+    int liftedRegion = -1;
+    float liftHeight = 0.0f;
+
+    void addRegion(int zone, int index, float x0, float y0, float x1, float y1) {
+        regions.push_back({ x0, y0, x1, y1, zone, index });
+    }
+
+    int cellIndex(float x, float y) const {
+        int column = std::min(std::max(static_cast<int>(x / CELL_SIZE), 0), columns - 1);
+        int row = std::min(std::max(static_cast<int>(y / CELL_SIZE), 0), rows - 1);
+        return row * columns + column;
+    }
+
+    template <typename Visit>
+    void forEachCell(const Region& region, Visit visit) const {
+        int first = cellIndex(region.x0, region.y0);
+        int last = cellIndex(region.x1, region.y1);
+        for (int row = first / columns; row <= last / columns; ++row) {
+            for (int column = first % columns; column <= last % columns; ++column) {
+                visit(row * columns + column);
+            }
+        }
+    }
+};
@@ -0,0 +1,236 @@
+#pragma once
+#include "GamePosition.h"
+#include "AIWorkerPool.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+struct ISMCTSConfig {
+    int iterations = 2000;
+    double timeBudgetMs = 0.0;  // when > 0, search until the deadline instead of counting iterations
+    double exploration = 0.7;
+};
+
+// The cards the side to move cannot see, narrowed by what it knows about
+// the opponent's hand (see CardTracker).
+struct HiddenCards {
+    CardMask unknown = 0;       // the opponent's hand plus the deck
+    CardMask opponentHas = 0;   // unknown cards the opponent certainly holds
+    CardMask opponentLacks = 0; // unknown cards the opponent cannot hold
+};
+
+// Single-observer information-set MCTS. Every iteration deals the unknown
+// cards (the opponent's hand and the deck) at random, then walks one shared
+// tree using only the moves legal in that deal. Each worker grows its own
+// tree and the root visit counts are summed at the end.
+class ISMCTS {
+public:
+    // Returns the card id to play for the side to move, or MOVE_END.
+    static int search(const GamePosition& position, const HiddenCards& hidden, const ISMCTSConfig& config,
+        AIWorkerPool* pool, int numTrees, unsigned int seed) {
+        MoveMask legal = position.legalMoves();
+        if (cardCount(legal) == 1) {
+            return lowestCard(legal);
+        }
+
+        numTrees = pool ? std::max(1, numTrees) : 1;
+        auto deadline = std::chrono::steady_clock::now() +
+            std::chrono::microseconds(static_cast<long long>(config.timeBudgetMs * 1000.0));
+
+        Arena& arena = localArena();
+        if (static_cast<int>(arena.trees.size()) < numTrees) {
+            arena.trees.resize(numTrees);
+        }
+        std::vector<Search>& searches = arena.searches;
+        searches.clear();
+        searches.reserve(numTrees);
+        for (int i = 0; i < numTrees; ++i) {
+            searches.emplace_back(arena.trees[i], position, hidden, config, deadline, seed + 7919u * i);
+            searches.back().iterations = (config.iterations + numTrees - 1) / numTrees;
+        }
+
+        if (numTrees == 1) {
+            searches[0].run();
+        }
+        else {
+            AIWorkerPool::TaskGroup group;
+            for (auto& search : searches) {
+                pool->submit(group, [](void* context) {
+                    static_cast<Search*>(context)->run();
+                    }, &search);
+            }
+            pool->wait(group);
+        }
+
+        long long visits[MOVE_END + 1] = {};
+        for (const auto& search : searches) {
+            search.addRootVisits(visits);
+        }
+
+        int bestMove = lowestCard(legal);
+        for (MoveMask moves = legal; moves; moves &= moves - 1) {
+            int move = lowestCard(moves);
+            if (visits[move] > visits[bestMove]) {
+                bestMove = move;
+            }
+        }
+        return bestMove;
+    }
+
+private:
+    struct Node {
+        int move;
+        int side;
+        int parent;
+        int firstChild;
+        int nextSibling;
+        MoveMask childMoves;
+        int visits;
+        int available;
+        double reward;
+    };
+
+    class Search {
+    public:
+        int iterations;
+
+        Search(std::vector<Node>& nodes, const GamePosition& position, const HiddenCards& hidden, const ISMCTSConfig& config,
+            std::chrono::steady_clock::time_point deadline, unsigned int seed)
+            : iterations(config.iterations), nodes(nodes), root(position), hidden(hidden), config(config),
+            deadline(deadline), rng(seed) {
+            nodes.clear();
+            nodes.reserve(std::min(iterations + 1, MAX_NODES));
+            nodes.push_back({ -1, 1 - position.sideToMove(), -1, -1, -1, 0, 0, 0, 0.0 });
+        }
+
+        void run() {
+            bool timed = config.timeBudgetMs > 0.0;
+            for (int i = 0; timed || i < iterations; ++i) {
+                if (timed && (i & 63) == 0 && std::chrono::steady_clock::now() >= deadline) {
+                    break;
+                }
+                iterate();
+            }
+        }
+
+        void addRootVisits(long long* visits) const {
+            for (int child = nodes[0].firstChild; child != -1; child = nodes[child].nextSibling) {
+                visits[nodes[child].move] += nodes[child].visits;
+            }
+        }
+
+    private:
+        static constexpr int MAX_NODES = 1 << 20;
+
+        std::vector<Node>& nodes;
+        GamePosition root;
+        HiddenCards hidden;
+        ISMCTSConfig config;
+        std::chrono::steady_clock::time_point deadline;
+        std::mt19937 rng;
+
+        int randomMove(MoveMask moves) {
+            int index = static_cast<int>(rng() % static_cast<unsigned int>(cardCount(moves)));
+            return cardAtIndex(moves, index);
+        }
+
+        // Deals the opponent the cards it is known to hold, fills its hand
+        // from the cards it may hold, and stacks the rest into the deck. Cards
+        // ruled out only go to the opponent when nothing else is left.
+        GamePosition determinize() {
+            GamePosition position = root;
+            int me = root.sideToMove();
+            int opponentCount = cardCount(root.hands[1 - me]);
+            CardMask known = hidden.opponentHas & hidden.unknown;
+            CardMask free = hidden.unknown & ~known;
+
+            int cards[CARD_COUNT];
+            int numLikely = 0;
+            for (CardMask likely = free & ~hidden.opponentLacks; likely; likely &= likely - 1) {
+                cards[numLikely++] = lowestCard(likely);
+            }
+            std::shuffle(cards, cards + numLikely, rng);
+            int numCards = numLikely;
+            for (CardMask unlikely = free & hidden.opponentLacks; unlikely; unlikely &= unlikely - 1) {
+                cards[numCards++] = lowestCard(unlikely);
+            }
+            std::shuffle(cards + numLikely, cards + numCards, rng);
+
+            position.hands[1 - me] = known;
+            int dealt = 0;
+            for (int toDeal = opponentCount - cardCount(known); dealt < toDeal && dealt < numCards; ++dealt) {
+                position.hands[1 - me] |= cardBit(cards[dealt]);
+            }
+            if (numCards > numLikely && dealt < numLikely) {
+                std::shuffle(cards + dealt, cards + numCards, rng);
+            }
+            position.deckSize = 0;
+            for (int i = dealt; i < numCards && position.deckSize < root.deckSize; ++i) {
+                position.deck[position.deckSize++] = cards[i];
+            }
+            return position;
+        }
+
+        void iterate() {
+            GamePosition position = determinize();
+            int node = 0;
+
+            while (!position.isTerminal()) {
+                MoveMask legal = position.legalMoves();
+                MoveMask untried = legal & ~nodes[node].childMoves;
+
+                if (untried && static_cast<int>(nodes.size()) < MAX_NODES) {
+                    int move = randomMove(untried);
+                    int child = static_cast<int>(nodes.size());
+                    nodes.push_back({ move, position.sideToMove(), node, -1, nodes[node].firstChild, 0, 0, 1, 0.0 });
+                    nodes[node].firstChild = child;
+                    nodes[node].childMoves |= cardBit(move);
+                    position.play(move);
+                    node = child;
+                    break;
+                }
+                if (untried) break;
+
+                int best = -1;
+                double bestScore = -1.0;
+                for (int child = nodes[node].firstChild; child != -1; child = nodes[child].nextSibling) {
+                    if (!(legal & cardBit(nodes[child].move))) continue;
+                    Node& n = nodes[child];
+                    n.available++;
+                    double score = n.reward / n.visits + config.exploration * std::sqrt(std::log(static_cast<double>(n.available)) / n.visits);
+                    if (score > bestScore) {
+                        bestScore = score;
+                        best = child;
+                    }
+                }
+
+                position.play(nodes[best].move);
+                node = best;
+            }
+
+            while (!position.isTerminal()) {
+                position.play(randomMove(position.legalMoves()));
+            }
+
+            for (; node != -1; node = nodes[node].parent) {
+                nodes[node].visits++;
+                nodes[node].reward += position.result(nodes[node].side);
+            }
+        }
+    };
+
+    // Node storage and search state for the calling thread, reused by every
+    // decision made from it: once the trees have grown to the iteration
+    // budget, a search allocates nothing.
+    struct Arena {
+        std::vector<std::vector<Node>> trees;
+        std::vector<Search> searches;
+    };
+
+    static Arena& localArena() {
+        thread_local Arena arena;
+        return arena;
+    }
+};
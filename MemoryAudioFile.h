@@ -0,0 +1,52 @@
+#pragma once
+#include "AssetPack.h"
+#include <sndfile.hh>
+#include <cstring>
+#include <cstdio>
+
+// libsndfile virtual I/O over bytes already in memory, so tracks decode
+// straight out of an AssetPack mapping. Must outlive the SNDFILE it opens.
+class MemoryAudioFile {
+public:
+    SNDFILE* open(const AssetView& view, SF_INFO& fileInfo) {
+        bytes = view;
+        position = 0;
+        fileInfo.format = 0;
+        return sf_open_virtual(&io(), SFM_READ, &fileInfo, this);
+    }
+
+private:
+    AssetView bytes;
+    sf_count_t position = 0;
+
+    static SF_VIRTUAL_IO& io() {
+        static SF_VIRTUAL_IO callbacks = { &length, &seek, &read, &write, &tell };
+        return callbacks;
+    }
+
+    static sf_count_t length(void* user) {
+        return static_cast<sf_count_t>(static_cast<MemoryAudioFile*>(user)->bytes.size);
+    }
+
+    static sf_count_t seek(sf_count_t offset, int whence, void* user) {
+        MemoryAudioFile& file = *static_cast<MemoryAudioFile*>(user);
+        sf_count_t size = static_cast<sf_count_t>(file.bytes.size);
+        sf_count_t target = whence == SEEK_SET ? offset : whence == SEEK_CUR ? file.position + offset : size + offset;
+        if (target < 0 || target > size) return -1;
+        file.position = target;
+        return target;
+    }
+
+    static sf_count_t read(void* destination, sf_count_t count, void* user) {
+        MemoryAudioFile& file = *static_cast<MemoryAudioFile*>(user);
+        sf_count_t available = static_cast<sf_count_t>(file.bytes.size) - file.position;
+        if (count > available) count = available;
+        std::memcpy(destination, file.bytes.data + file.position, static_cast<size_t>(count));
+        file.position += count;
+        return count;
+    }
+
+    static sf_count_t write(const void*, sf_count_t, void*) { return 0; }
+
+    static sf_count_t tell(void* user) { return static_cast<MemoryAudioFile*>(user)->position; }
+};
@@ -0,0 +1,159 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Probes are on in debug builds and in any build configured with
+// -DCARDGAME_PROFILE; in release builds PROFILE_SCOPE expands to nothing.
+#if !defined(NDEBUG) || defined(CARDGAME_PROFILE)
+#define CARDGAME_PROFILING 1
+#endif
+
+struct ProfileEvent {
+    const char* name;   // a string literal; events keep the pointer
+    uint64_t start;     // nanoseconds on the profiler clock
+    uint64_t end;
+};
+
+// Scoped timing probes. Each thread writes its events into its own ring
+// buffer, so recording is a clock read and two stores with no lock; the
+// oldest events are overwritten once a ring is full. dumpChromeTrace() reads
+// every ring and writes the Chrome trace event format (chrome://tracing,
+// Perfetto). The main loop also reports frame times for the overlay.
+class Profiler {
+public:
+    static constexpr int RING_SIZE = 8192;  // events per thread, a power of two
+    static constexpr int FRAME_HISTORY = 120;
+
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    static uint64_t now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void record(const char* name, uint64_t start, uint64_t end) {
+        ThreadRing& ring = localRing();
+        uint32_t index = ring.written.load(std::memory_order_relaxed);
+        ring.events[index & (RING_SIZE - 1)] = { name, start, end };
+        ring.written.store(index + 1, std::memory_order_release);
+    }
+
+    // Names the calling thread in the trace.
+    void setThreadName(const std::string& name) {
+        localRing().name = name;
+    }
+
+    // Called by the main thread once per presented frame.
+    void endFrame(uint64_t frameStart) {
+        uint64_t frameEnd = now();
+        record("Frame", frameStart, frameEnd);
+        frameTimes[frameCount % FRAME_HISTORY] = static_cast<float>((frameEnd - frameStart) / 1.0e6);
+        ++frameCount;
+    }
+
+    // Milliseconds of the i-th most recent frame, 0 being the newest.
+    float getFrameTime(int i) const {
+        if (i >= FRAME_HISTORY || i >= frameCount) return 0.0f;
+        return frameTimes[(frameCount - 1 - i) % FRAME_HISTORY];
+    }
+
+    int getFrameCount() const { return frameCount; }
+
+    // Writes every event still held in the rings. Safe while other threads
+    // keep recording: events a writer may have overwritten during the copy
+    // are dropped.
+    bool dumpChromeTrace(const std::string& path) {
+        std::ofstream file(path);
+        if (!file) return false;
+
+        std::vector<ProfileEvent> events;
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        file << "{\"traceEvents\":[\n";
+        bool first = true;
+        for (size_t tid = 0; tid < rings.size(); ++tid) {
+            ThreadRing& ring = *rings[tid];
+            uint32_t end = ring.written.load(std::memory_order_acquire);
+            uint32_t begin = end > RING_SIZE ? end - RING_SIZE : 0;
+            events.clear();
+            for (uint32_t i = begin; i != end; ++i) {
+                events.push_back(ring.events[i & (RING_SIZE - 1)]);
+            }
+            // The writer may have wrapped onto the oldest copied slots meanwhile,
+            // including the slot it is writing right now.
+            uint32_t after = ring.written.load(std::memory_order_acquire);
+            uint32_t oldestIntact = after >= RING_SIZE ? after - RING_SIZE + 1 : 0;
+            size_t skip = oldestIntact > begin ? std::min<size_t>(oldestIntact - begin, events.size()) : 0;
+
+            if (!first) file << ",\n";
+            first = false;
+            file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+                << ",\"args\":{\"name\":\"" << (ring.name.empty() ? "thread " + std::to_string(tid) : ring.name) << "\"}}";
+            for (size_t i = skip; i < events.size(); ++i) {
+                const ProfileEvent& event = events[i];
+                file << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                    << ",\"ts\":" << (event.start - epoch) / 1000.0
+                    << ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+            }
+        }
+        file << "\n]}\n";
+        return static_cast<bool>(file);
+    }
+
+private:
+    struct ThreadRing {
+        std::atomic<uint32_t> written{ 0 };
+        ProfileEvent events[RING_SIZE];
+        std::string name;
+    };
+
+    // Rings live as long as the profiler, so a dump still sees threads that exited.
+    std::mutex ringsMutex;
+    std::vector<std::unique_ptr<ThreadRing>> rings;
+    uint64_t epoch;
+    float frameTimes[FRAME_HISTORY] = {};
+    int frameCount = 0;
+
+    Profiler() : epoch(now()) {}
+
+    ThreadRing& localRing() {
+        thread_local ThreadRing* ring = nullptr;
+        if (!ring) {
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            rings.emplace_back(new ThreadRing());
+            ring = rings.back().get();
+        }
+        return *ring;
+    }
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : name(name), start(Profiler::now()) {}
+    ~ProfileScope() { Profiler::instance().record(name, start, Profiler::now()); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    uint64_t start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef CARDGAME_PROFILING
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) do {} while (0)
+#endif
@@ -0,0 +1,219 @@
+#pragma once
+#include "GameLogic.h"
+#include "GameLog.h"
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+struct SelfPlayConfig {
+    long long games = 1000;
+    int workers = 1;
+    int playerAIThreads = 1;
+    int computerAIThreads = 4;
+    AIMode playerAIMode = AIMode::HEURISTIC;
+    AIMode computerAIMode = AIMode::HEURISTIC;
+    ISMCTSConfig ismcts;
+    bool playerEndgameSolver = false;   // exact endgame search; about 100x fewer games/s
+    bool computerEndgameSolver = false;
+    int maxActions = 1000;
+    uint64_t seed = 0;      // game i is dealt from seed + i
+    bool record = false;    // keep a GameLog of every game
+    AIWeights playerWeights;
+    AIWeights computerWeights;
+};
+
+struct SelfPlayStats {
+    long long games = 0;
+    long long playerWins = 0;
+    long long computerWins = 0;
+    long long draws = 0;
+    long long aborted = 0;
+    long long actions = 0;
+    double seconds = 0.0;
+
+    void add(const SelfPlayStats& other) {
+        games += other.games;
+        playerWins += other.playerWins;
+        computerWins += other.computerWins;
+        draws += other.draws;
+        aborted += other.aborted;
+        actions += other.actions;
+    }
+
+    double gamesPerSecond() const { return seconds > 0.0 ? games / seconds : 0.0; }
+};
+
+struct MoveLatencyStats {
+    long long moves = 0;
+    double simpleSeconds = 0.0;
+    double multiThreadSeconds = 0.0;
+
+    double simpleMicros() const { return moves > 0 ? 1e6 * simpleSeconds / moves : 0.0; }
+    double multiThreadMicros() const { return moves > 0 ? 1e6 * multiThreadSeconds / moves : 0.0; }
+};
+
+// Plays AI-vs-AI games through the same state transitions as Game::update,
+// without a window, so thousands of games can be run per second.
+class SelfPlayEngine {
+public:
+    enum class Result {
+        PLAYER_WINS,
+        COMPUTER_WINS,
+        DRAW,
+        ABORTED
+    };
+
+    explicit SelfPlayEngine(const SelfPlayConfig& config) : config(config) {}
+
+    Result playGame(GameLogic& gameLogic, int& actions, uint64_t gameSeed, GameLog* log = nullptr) {
+        GameLog::deal(gameLogic, gameSeed);
+        gameLogic.setISMCTSConfig(config.ismcts);
+        gameLogic.setPlayerAIWeights(config.playerWeights);
+        gameLogic.setAIWeights(config.computerWeights);
+        if (log) log->start(gameSeed);
+
+        GameState state = GameState::PLAYER_TURN_ATTACK;
+        actions = 0;
+
+        while (!gameLogic.isGameOver()) {
+            if (actions >= config.maxActions) {
+                return Result::ABORTED;
+            }
+            state = step(gameLogic, state, log);
+            ++actions;
+        }
+
+        if (gameLogic.getPlayerHand() == 0 && gameLogic.getComputerHand() == 0) {
+            return Result::DRAW;
+        }
+        return gameLogic.getPlayerHand() == 0 ? Result::PLAYER_WINS : Result::COMPUTER_WINS;
+    }
+
+    SelfPlayStats run() {
+        int workers = std::max(1, config.workers);
+        std::vector<SelfPlayStats> workerStats(workers);
+        std::vector<std::thread> threads;
+        std::atomic<long long> nextGame(0);
+        if (config.record) logs.assign(config.games, GameLog());
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int w = 0; w < workers; ++w) {
+            threads.emplace_back([this, &workerStats, &nextGame, w]() {
+                GameLogic gameLogic;
+                SelfPlayStats& stats = workerStats[w];
+
+                for (long long game = nextGame.fetch_add(1); game < config.games; game = nextGame.fetch_add(1)) {
+                    int actions = 0;
+                    GameLog* log = config.record ? &logs[game] : nullptr;
+                    Result result = playGame(gameLogic, actions, config.seed + game, log);
+
+                    stats.games++;
+                    stats.actions += actions;
+                    switch (result) {
+                    case Result::PLAYER_WINS: stats.playerWins++; break;
+                    case Result::COMPUTER_WINS: stats.computerWins++; break;
+                    case Result::DRAW: stats.draws++; break;
+                    case Result::ABORTED: stats.aborted++; break;
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        SelfPlayStats total;
+        for (const auto& stats : workerStats) {
+            total.add(stats);
+        }
+        total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return total;
+    }
+
+    // The games recorded by the last run() when config.record is set, in game order.
+    const std::vector<GameLog>& getLogs() const { return logs; }
+
+    // Replays recorded games through the rules only. Returns the number of
+    // games whose actions no longer matched.
+    static long long replay(const std::vector<GameLog>& games, SelfPlayStats& stats) {
+        GameLogic gameLogic;
+        long long mismatches = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (const GameLog& log : games) {
+            if (!log.replay(gameLogic)) {
+                mismatches++;
+                continue;
+            }
+            stats.games++;
+            stats.actions += static_cast<long long>(log.actions.size());
+            if (!gameLogic.isGameOver()) stats.aborted++;
+            else if (gameLogic.getPlayerHand() == 0 && gameLogic.getComputerHand() == 0) stats.draws++;
+            else if (gameLogic.getPlayerHand() == 0) stats.playerWins++;
+            else stats.computerWins++;
+        }
+
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return mismatches;
+    }
+
+    // Times calculateAIMove on every computer decision of config.games games,
+    // once through the simple path and once through the worker pool.
+    MoveLatencyStats measureMoveLatency() {
+        MoveLatencyStats latency;
+        GameLogic gameLogic;
+        int numThreads = std::max(2, config.computerAIThreads);
+
+        for (long long game = 0; game < config.games; ++game) {
+            GameLog::deal(gameLogic, config.seed + game);
+
+            GameState state = GameState::PLAYER_TURN_ATTACK;
+            for (int actions = 0; !gameLogic.isGameOver() && actions < config.maxActions; ++actions) {
+                if (state == GameState::COMPUTER_TURN_ATTACK || state == GameState::COMPUTER_TURN_DEFEND) {
+                    bool isAttackTurn = state == GameState::COMPUTER_TURN_ATTACK;
+
+                    auto start = std::chrono::steady_clock::now();
+                    gameLogic.calculateAIMove(isAttackTurn, 1);
+                    auto middle = std::chrono::steady_clock::now();
+                    gameLogic.calculateAIMove(isAttackTurn, numThreads);
+                    auto end = std::chrono::steady_clock::now();
+
+                    latency.moves++;
+                    latency.simpleSeconds += std::chrono::duration<double>(middle - start).count();
+                    latency.multiThreadSeconds += std::chrono::duration<double>(end - middle).count();
+                }
+                state = step(gameLogic, state, nullptr);
+            }
+        }
+
+        return latency;
+    }
+
+private:
+    SelfPlayConfig config;
+    std::vector<GameLog> logs;
+
+    // Lets the AI of the side to move pick an action and applies it with the
+    // same transitions a replay uses.
+    GameState step(GameLogic& gameLogic, GameState state, GameLog* log) {
+        bool playerSeat = state == GameState::PLAYER_TURN_ATTACK || state == GameState::PLAYER_TURN_DEFEND;
+        gameLogic.setAIMode(playerSeat ? config.playerAIMode : config.computerAIMode);
+        gameLogic.setEndgameSolver(playerSeat ? config.playerEndgameSolver : config.computerEndgameSolver);
+
+        bool isAttackTurn = state == GameState::PLAYER_TURN_ATTACK || state == GameState::COMPUTER_TURN_ATTACK;
+        int cardIndex = playerSeat ? gameLogic.calculatePlayerAIMove(isAttackTurn, config.playerAIThreads)
+            : gameLogic.calculateAIMove(isAttackTurn, config.computerAIThreads);
+        int cardId = cardIndex < 0 ? -1 : cardAtIndex(playerSeat ? gameLogic.getPlayerHand() : gameLogic.getComputerHand(), cardIndex);
+
+        uint8_t code;
+        if (cardId == -1) code = GameLog::encode(isAttackTurn ? GameLog::END_MOVE : GameLog::TAKE);
+        else code = GameLog::encode(isAttackTurn ? GameLog::ATTACK : GameLog::DEFEND, cardId);
+
+        GameState next = GameLog::apply(gameLogic, state, code);
+        if (log) log->record(code);
+        return next;
+    }
+};
@@ -0,0 +1,109 @@
+#pragma once
+#include "AssetLoader.h"
+#include <AL/al.h>
+#include <iostream>
+
+// Sound effects played from a fixed pool of AL sources. Decoded clips are
+// cached as AL buffers by sound id when loaded, so play() only picks a voice
+// and starts it: no allocation, no file access. When every voice is busy the
+// new sound steals the oldest voice of the lowest priority, as long as that
+// priority is not above its own; otherwise it is dropped.
+class SoundMixer {
+public:
+    static constexpr int MAX_SOUNDS = 32;
+    static constexpr int VOICE_COUNT = 16;
+
+    SoundMixer() : initialized(false), playCounter(0) {
+        for (auto& buffer : buffers) buffer = 0;
+    }
+
+    ~SoundMixer() {
+        shutdown();
+    }
+
+    SoundMixer(const SoundMixer&) = delete;
+    SoundMixer& operator=(const SoundMixer&) = delete;
+
+    // Needs a current AL context.
+    void init() {
+        if (initialized) return;
+        for (auto& voice : voices) {
+            alGenSources(1, &voice.source);
+            voice.priority = 0;
+            voice.startedAt = 0;
+        }
+        initialized = true;
+    }
+
+    void shutdown() {
+        if (!initialized) return;
+        for (auto& voice : voices) {
+            alSourceStop(voice.source);
+            alDeleteSources(1, &voice.source);
+        }
+        for (auto& buffer : buffers) {
+            if (buffer) alDeleteBuffers(1, &buffer);
+            buffer = 0;
+        }
+        initialized = false;
+    }
+
+    bool loadSound(int soundId, const DecodedAudio& audio) {
+        if (soundId < 0 || soundId >= MAX_SOUNDS || audio.samples.empty()) return false;
+        if (buffers[soundId]) alDeleteBuffers(1, &buffers[soundId]);
+
+        alGenBuffers(1, &buffers[soundId]);
+        alBufferData(buffers[soundId], audio.channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16,
+            audio.samples.data(), static_cast<ALsizei>(audio.samples.size() * sizeof(short)), static_cast<ALsizei>(audio.sampleRate));
+        return true;
+    }
+
+    // Returns the voice index used, or -1 if the sound is not loaded or was dropped.
+    int play(int soundId, int priority, float gain = 1.0f) {
+        if (!initialized || soundId < 0 || soundId >= MAX_SOUNDS || buffers[soundId] == 0) return -1;
+
+        int chosen = -1;
+        for (int i = 0; i < VOICE_COUNT; ++i) {
+            ALint state;
+            alGetSourcei(voices[i].source, AL_SOURCE_STATE, &state);
+            if (state != AL_PLAYING) {
+                chosen = i;
+                break;
+            }
+            if (voices[i].priority > priority) continue;
+            if (chosen == -1 || voices[i].priority < voices[chosen].priority ||
+                (voices[i].priority == voices[chosen].priority && voices[i].startedAt < voices[chosen].startedAt)) {
+                chosen = i;
+            }
+        }
+        if (chosen == -1) return -1;
+
+        Voice& voice = voices[chosen];
+        alSourceStop(voice.source);
+        alSourcei(voice.source, AL_BUFFER, static_cast<ALint>(buffers[soundId]));
+        alSourcef(voice.source, AL_GAIN, gain);
+        alSourcePlay(voice.source);
+        voice.priority = priority;
+        voice.startedAt = ++playCounter;
+        return chosen;
+    }
+
+    void stopAll() {
+        if (!initialized) return;
+        for (auto& voice : voices) {
+            alSourceStop(voice.source);
+        }
+    }
+
+private:
+    struct Voice {
+        ALuint source;
+        int priority;
+        unsigned long long startedAt;
+    };
+
+    Voice voices[VOICE_COUNT];
+    ALuint buffers[MAX_SOUNDS];
+    bool initialized;
+    unsigned long long playCounter;
+};
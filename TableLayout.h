@@ -0,0 +1,123 @@
+#pragma once
+#include "CardMask.h"
+#include "Card.h"
+#include <algorithm>
+
+// Screen rectangles for every card on the table, kept apart from the game
+// state. update() only re-lays out when the hands, the table or the trump
+// changed since the last call. The result is a structure of arrays in draw
+// order (computer hand, table, player hand, trump) that both the renderer and
+// mouse hit testing read.
+class TableLayout {
+public:
+    enum Zone {
+        ZONE_COMPUTER_HAND = 0,
+        ZONE_TABLE = 1,
+        ZONE_PLAYER_HAND = 2,
+        ZONE_TRUMP = 3,
+        ZONE_COUNT = 4
+    };
+
+    static constexpr int MAX_CARDS = CARD_COUNT + 1;
+    static constexpr float HAND_MARGIN = 20.0f;
+
+    TableLayout(float windowWidth, float windowHeight, float cardWidth, float cardHeight)
+        : windowWidth(windowWidth), windowHeight(windowHeight), cardWidth(cardWidth), cardHeight(cardHeight),
+        count(0), valid(false), playerHand(0), computerHand(0), tableSize(0), trumpId(-1) {
+        std::fill(zoneStart, zoneStart + ZONE_COUNT + 1, 0);
+    }
+
+    // Returns true if the layout changed.
+    bool update(CardMask newPlayerHand, CardMask newComputerHand, const int* newTable, int newTableSize, int newTrumpId) {
+        if (valid && newPlayerHand == playerHand && newComputerHand == computerHand && newTrumpId == trumpId &&
+            newTableSize == tableSize && std::equal(newTable, newTable + newTableSize, table)) {
+            return false;
+        }
+
+        playerHand = newPlayerHand;
+        computerHand = newComputerHand;
+        tableSize = newTableSize;
+        std::copy(newTable, newTable + newTableSize, table);
+        trumpId = newTrumpId;
+        valid = true;
+        count = 0;
+
+        zoneStart[ZONE_COMPUTER_HAND] = count;
+        layoutHand(computerHand, windowHeight - 50.0f - cardHeight, false);
+
+        zoneStart[ZONE_TABLE] = count;
+        int columns = std::max(4, (tableSize + 1) / 2);
+        float tableStartX = (windowWidth - columns * cardWidth) / 2.0f;
+        float tableY = windowHeight / 2.0f - cardHeight / 2.0f;
+        for (int i = 0; i < tableSize; ++i) {
+            add(table[i], tableStartX + (i % columns) * cardWidth, tableY - (i / columns) * (cardHeight + 10), true);
+        }
+
+        zoneStart[ZONE_PLAYER_HAND] = count;
+        layoutHand(playerHand, 50.0f, true);
+
+        zoneStart[ZONE_TRUMP] = count;
+        if (trumpId != -1 && Card::rankOf(trumpId) != Card::JOKER_RANK) {
+            add(trumpId, windowWidth - cardWidth - 20, windowHeight / 2 - cardHeight / 2, true);
+        }
+        zoneStart[ZONE_COUNT] = count;
+        return true;
+    }
+
+    void invalidate() { valid = false; }
+
+    int size() const { return count; }
+    int zoneBegin(Zone zone) const { return zoneStart[zone]; }
+    int zoneEnd(Zone zone) const { return zoneStart[zone + 1]; }
+    float getCardWidth() const { return cardWidth; }
+    float getCardHeight() const { return cardHeight; }
+
+    // Structure-of-arrays view, indexed 0..size()-1.
+    const float* xs() const { return x; }
+    const float* ys() const { return y; }
+    const int* cardIds() const { return cardId; }
+    const bool* faceUps() const { return faceUp; }
+
+private:
+    float windowWidth;
+    float windowHeight;
+    float cardWidth;
+    float cardHeight;
+
+    float x[MAX_CARDS];
+    float y[MAX_CARDS];
+    int cardId[MAX_CARDS];
+    bool faceUp[MAX_CARDS];
+    int zoneStart[ZONE_COUNT + 1];
+    int count;
+
+    bool valid;
+    CardMask playerHand;
+    CardMask computerHand;
+    int table[CARD_COUNT];
+    int tableSize;
+    int trumpId;
+
+    void add(int id, float cardX, float cardY, bool isFaceUp) {
+        x[count] = cardX;
+        y[count] = cardY;
+        cardId[count] = id;
+        faceUp[count] = isFaceUp;
+        ++count;
+    }
+
+    // Cards sit side by side until the hand would not fit between the
+    // margins; after that they overlap, each covering part of the one before.
+    void layoutHand(CardMask hand, float handY, bool isFaceUp) {
+        int cards = cardCount(hand);
+        float maxWidth = windowWidth - 2 * HAND_MARGIN;
+        float step = cardWidth;
+        if (cards > 1 && cards * cardWidth > maxWidth) {
+            step = (maxWidth - cardWidth) / (cards - 1);
+        }
+        float startX = (windowWidth - (cards - 1) * step - cardWidth) / 2.0f;
+        for (int i = 0; hand; hand &= hand - 1, ++i) {
+            add(lowestCard(hand), startX + i * step, handY, isFaceUp);
+        }
+    }
+};
@@ -0,0 +1,333 @@
+#pragma once
+#include "CompressedTexture.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// 8-bit RGBA pixels, rows in the order they are uploaded.
+struct RgbaImage {
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;
+};
+
+// CPU encoder for the S3TC formats CompressedTexture holds, so textures can be
+// converted offline on machines without a GPU. Every mip level is box-filtered
+// from the one above and encoded separately. Opaque images become BC1, images
+// whose alpha is only ever 0 or 255 become BC1 with punch-through alpha, and
+// anything else BC3. Colour endpoints start at the block's extremes along its
+// principal axis and get one least-squares refinement.
+class TextureCompressor {
+public:
+    static CompressedTexture compress(const RgbaImage& image) {
+        std::vector<RgbaImage> chain;
+        chain.push_back(image);
+        while (chain.back().width > 1 || chain.back().height > 1) {
+            chain.push_back(downsample(chain.back()));
+        }
+
+        CompressedTexture texture;
+        texture.format = chooseFormat(image);
+        size_t total = 0;
+        for (const RgbaImage& level : chain) {
+            total += CompressedTexture::levelSize(texture.format, level.width, level.height);
+        }
+        texture.storage.resize(total);
+
+        size_t offset = 0;
+        for (const RgbaImage& level : chain) {
+            size_t size = CompressedTexture::levelSize(texture.format, level.width, level.height);
+            encodeLevel(level, texture.format, texture.storage.data() + offset);
+            texture.levels.push_back({ level.width, level.height, texture.storage.data() + offset, size });
+            offset += size;
+        }
+        return texture;
+    }
+
+    static uint32_t chooseFormat(const RgbaImage& image) {
+        bool transparent = false;
+        for (size_t i = 3; i < image.pixels.size(); i += 4) {
+            unsigned char alpha = image.pixels[i];
+            if (alpha != 0 && alpha != 255) return CompressedTexture::BC3_RGBA;
+            transparent = transparent || alpha == 0;
+        }
+        return transparent ? CompressedTexture::BC1_RGBA : CompressedTexture::BC1_RGB;
+    }
+
+    // Halves each dimension (down to 1), averaging 2x2 boxes; the last box of
+    // an odd row or column widens to 3 so the edge pixels are not dropped.
+    static RgbaImage downsample(const RgbaImage& image) {
+        RgbaImage half;
+        half.width = std::max(1, image.width / 2);
+        half.height = std::max(1, image.height / 2);
+        half.pixels.resize(static_cast<size_t>(half.width) * half.height * 4);
+
+        for (int y = 0; y < half.height; ++y) {
+            int y0 = std::min(2 * y, image.height - 1);
+            int y1 = y == half.height - 1 ? image.height : y0 + 2;
+            for (int x = 0; x < half.width; ++x) {
+                int x0 = std::min(2 * x, image.width - 1);
+                int x1 = x == half.width - 1 ? image.width : x0 + 2;
+
+                unsigned int sum[4] = { 0, 0, 0, 0 };
+                for (int sy = y0; sy < y1; ++sy) {
+                    const unsigned char* pixel = &image.pixels[(static_cast<size_t>(sy) * image.width + x0) * 4];
+                    for (int sx = x0; sx < x1; ++sx, pixel += 4) {
+                        for (int i = 0; i < 4; ++i) sum[i] += pixel[i];
+                    }
+                }
+
+                unsigned int count = static_cast<unsigned int>((y1 - y0) * (x1 - x0));
+                unsigned char* out = &half.pixels[(static_cast<size_t>(y) * half.width + x) * 4];
+                for (int i = 0; i < 4; ++i) {
+                    out[i] = static_cast<unsigned char>((sum[i] + count / 2) / count);
+                }
+            }
+        }
+        return half;
+    }
+
+    // Blocks that hang over the right or top edge repeat the edge pixels.
+    static void encodeLevel(const RgbaImage& image, uint32_t format, unsigned char* out) {
+        unsigned char block[16 * 4];
+        for (int by = 0; by < image.height; by += 4) {
+            for (int bx = 0; bx < image.width; bx += 4) {
+                for (int i = 0; i < 16; ++i) {
+                    int x = std::min(bx + i % 4, image.width - 1);
+                    int y = std::min(by + i / 4, image.height - 1);
+                    const unsigned char* pixel = &image.pixels[(static_cast<size_t>(y) * image.width + x) * 4];
+                    std::copy(pixel, pixel + 4, block + i * 4);
+                }
+
+                if (format == CompressedTexture::BC3_RGBA) {
+                    encodeAlphaBlock(block, out);
+                    encodeColorBlock(block, false, out + 8);
+                    out += 16;
+                }
+                else {
+                    encodeColorBlock(block, format == CompressedTexture::BC1_RGBA, out);
+                    out += 8;
+                }
+            }
+        }
+    }
+
+    // One 8-byte colour block: two RGB565 endpoints and 2-bit indices. With
+    // punchThrough, pixels with alpha below 128 use the transparent index,
+    // which needs the three-colour mode (first endpoint <= second).
+    static void encodeColorBlock(const unsigned char* block, bool punchThrough, unsigned char* out) {
+        bool transparent[16];
+        bool anyTransparent = false;
+        int opaque = 0;
+        float mean[3] = { 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < 16; ++i) {
+            transparent[i] = punchThrough && block[i * 4 + 3] < 128;
+            anyTransparent = anyTransparent || transparent[i];
+            if (transparent[i]) continue;
+            ++opaque;
+            for (int c = 0; c < 3; ++c) mean[c] += block[i * 4 + c];
+        }
+
+        if (opaque == 0) {
+            writeColorBlock(out, 0, 0, 0xFFFFFFFFu);
+            return;
+        }
+        for (int c = 0; c < 3; ++c) mean[c] /= opaque;
+
+        // Principal axis of the colours by power iteration on their covariance.
+        float cov[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < 16; ++i) {
+            if (transparent[i]) continue;
+            float r = block[i * 4] - mean[0];
+            float g = block[i * 4 + 1] - mean[1];
+            float b = block[i * 4 + 2] - mean[2];
+            cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+            cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+        }
+        float axis[3] = { 1.0f, 1.0f, 1.0f };
+        for (int iteration = 0; iteration < 8; ++iteration) {
+            float next[3] = {
+                cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+                cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+                cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2]
+            };
+            float length = std::max(std::max(std::abs(next[0]), std::abs(next[1])), std::abs(next[2]));
+            if (length < 1e-6f) break;
+            for (int c = 0; c < 3; ++c) axis[c] = next[c] / length;
+        }
+
+        int lowest = -1, highest = -1;
+        float lowestDot = 0.0f, highestDot = 0.0f;
+        for (int i = 0; i < 16; ++i) {
+            if (transparent[i]) continue;
+            float dot = block[i * 4] * axis[0] + block[i * 4 + 1] * axis[1] + block[i * 4 + 2] * axis[2];
+            if (lowest < 0 || dot < lowestDot) { lowest = i; lowestDot = dot; }
+            if (highest < 0 || dot > highestDot) { highest = i; highestDot = dot; }
+        }
+
+        uint16_t c0 = toRgb565(block + highest * 4);
+        uint16_t c1 = toRgb565(block + lowest * 4);
+        uint32_t indices;
+        int error = fitColorBlock(block, transparent, anyTransparent, c0, c1, indices);
+
+        uint16_t r0 = c0, r1 = c1;
+        uint32_t refinedIndices;
+        if (refineEndpoints(block, transparent, anyTransparent, indices, r0, r1) &&
+            fitColorBlock(block, transparent, anyTransparent, r0, r1, refinedIndices) < error) {
+            c0 = r0;
+            c1 = r1;
+            indices = refinedIndices;
+        }
+        writeColorBlock(out, c0, c1, indices);
+    }
+
+    // One 8-byte BC3 alpha block: the block's alpha range and 3-bit indices
+    // into the eight-value ramp between its ends.
+    static void encodeAlphaBlock(const unsigned char* block, unsigned char* out) {
+        int lowest = 255, highest = 0;
+        for (int i = 0; i < 16; ++i) {
+            lowest = std::min(lowest, static_cast<int>(block[i * 4 + 3]));
+            highest = std::max(highest, static_cast<int>(block[i * 4 + 3]));
+        }
+
+        int ramp[8] = { highest, lowest };
+        for (int i = 2; i < 8; ++i) {
+            ramp[i] = ((8 - i) * highest + (i - 1) * lowest) / 7;
+        }
+
+        uint64_t bits = 0;
+        if (highest != lowest) {
+            for (int i = 0; i < 16; ++i) {
+                int alpha = block[i * 4 + 3];
+                int best = 0;
+                for (int j = 1; j < 8; ++j) {
+                    if (std::abs(ramp[j] - alpha) < std::abs(ramp[best] - alpha)) best = j;
+                }
+                bits |= static_cast<uint64_t>(best) << (3 * i);
+            }
+        }
+
+        out[0] = static_cast<unsigned char>(highest);
+        out[1] = static_cast<unsigned char>(lowest);
+        for (int i = 0; i < 6; ++i) {
+            out[2 + i] = static_cast<unsigned char>(bits >> (8 * i));
+        }
+    }
+
+    static void rgb565ToRgb(uint16_t color, int* rgb) {
+        int r = color >> 11, g = (color >> 5) & 63, b = color & 31;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+
+    // The colours a decoder derives from the endpoints; the fourth is unused
+    // (transparent black) in three-colour mode.
+    static void colorPalette(uint16_t c0, uint16_t c1, int palette[4][3]) {
+        rgb565ToRgb(c0, palette[0]);
+        rgb565ToRgb(c1, palette[1]);
+        for (int c = 0; c < 3; ++c) {
+            if (c0 > c1) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            else {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+        }
+    }
+
+private:
+    static uint16_t toRgb565(const unsigned char* rgb) {
+        return static_cast<uint16_t>(((rgb[0] * 31 + 127) / 255) << 11 | ((rgb[1] * 63 + 127) / 255) << 5 | ((rgb[2] * 31 + 127) / 255));
+    }
+
+    static uint16_t toRgb565(const float* rgb) {
+        int r = std::min(31, std::max(0, static_cast<int>(rgb[0] * 31.0f / 255.0f + 0.5f)));
+        int g = std::min(63, std::max(0, static_cast<int>(rgb[1] * 63.0f / 255.0f + 0.5f)));
+        int b = std::min(31, std::max(0, static_cast<int>(rgb[2] * 31.0f / 255.0f + 0.5f)));
+        return static_cast<uint16_t>(r << 11 | g << 5 | b);
+    }
+
+    // Orders the endpoints for the mode the block needs (three-colour when
+    // some pixels are transparent, four-colour otherwise; equal endpoints
+    // decode as three-colour either way), picks the nearest palette entry
+    // for each pixel and returns the squared error.
+    static int fitColorBlock(const unsigned char* block, const bool* transparent, bool anyTransparent,
+        uint16_t& c0, uint16_t& c1, uint32_t& indices) {
+        if (anyTransparent ? c0 > c1 : c0 < c1) std::swap(c0, c1);
+        int palette[4][3];
+        colorPalette(c0, c1, palette);
+        int choices = c0 > c1 ? 4 : 3;
+
+        int error = 0;
+        indices = 0;
+        for (int i = 0; i < 16; ++i) {
+            if (transparent[i]) {
+                indices |= 3u << (2 * i);
+                continue;
+            }
+            int best = 0, bestError = 0;
+            for (int j = 0; j < choices; ++j) {
+                int dr = palette[j][0] - block[i * 4];
+                int dg = palette[j][1] - block[i * 4 + 1];
+                int db = palette[j][2] - block[i * 4 + 2];
+                int distance = dr * dr + dg * dg + db * db;
+                if (j == 0 || distance < bestError) {
+                    best = j;
+                    bestError = distance;
+                }
+            }
+            indices |= static_cast<uint32_t>(best) << (2 * i);
+            error += bestError;
+        }
+        return error;
+    }
+
+    // Least-squares endpoints for the given indices: each pixel is modelled as
+    // (1 - t) * c0 + t * c1 with t fixed by its index.
+    static bool refineEndpoints(const unsigned char* block, const bool* transparent, bool threeColor,
+        uint32_t indices, uint16_t& c0, uint16_t& c1) {
+        const float fourColorT[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+        const float threeColorT[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+        const float* weights = threeColor || c0 <= c1 ? threeColorT : fourColorT;
+
+        float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+        float ax[3] = { 0.0f, 0.0f, 0.0f }, bx[3] = { 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < 16; ++i) {
+            if (transparent[i]) continue;
+            float t = weights[(indices >> (2 * i)) & 3];
+            float s = 1.0f - t;
+            aa += s * s;
+            ab += s * t;
+            bb += t * t;
+            for (int c = 0; c < 3; ++c) {
+                ax[c] += s * block[i * 4 + c];
+                bx[c] += t * block[i * 4 + c];
+            }
+        }
+
+        float determinant = aa * bb - ab * ab;
+        if (determinant < 1e-4f) return false;
+        float first[3], second[3];
+        for (int c = 0; c < 3; ++c) {
+            first[c] = (bb * ax[c] - ab * bx[c]) / determinant;
+            second[c] = (aa * bx[c] - ab * ax[c]) / determinant;
+        }
+        c0 = toRgb565(first);
+        c1 = toRgb565(second);
+        return true;
+    }
+
+    static void writeColorBlock(unsigned char* out, uint16_t c0, uint16_t c1, uint32_t indices) {
+        out[0] = static_cast<unsigned char>(c0);
+        out[1] = static_cast<unsigned char>(c0 >> 8);
+        out[2] = static_cast<unsigned char>(c1);
+        out[3] = static_cast<unsigned char>(c1 >> 8);
+        for (int i = 0; i < 4; ++i) {
+            out[4 + i] = static_cast<unsigned char>(indices >> (8 * i));
+        }
+    }
+};
@@ -0,0 +1,112 @@
+#pragma once
+#include "SelfPlay.h"
+#include "AIWeights.h"
+#include <cmath>
+#include <random>
+#include <iostream>
+
+struct TunerConfig {
+    int iterations = 200;
+    long long games = 2000;         // deals per evaluation; each is played from both seats
+    long long verifyGames = 20000;  // deals for the final tuned-vs-start match
+    int workers = 1;
+    uint64_t seed = 0;
+    double learningRate = 2.0;      // SPSA a
+    double perturbation = 0.2;      // SPSA c, as a fraction of each weight's scale
+};
+
+// SPSA over the heuristic AI's weights. Every iteration perturbs all weights
+// at once in a random +/- direction, plays the two perturbed sets against
+// each other on the same deals from both seats, and steps along the
+// estimated gradient of the win rate. Games run on config.workers threads
+// with single-threaded AI and no endgame solver, so only the weights decide.
+class WeightTuner {
+public:
+    WeightTuner(const TunerConfig& config, const AIWeights& start) : config(config), start(start), rng(config.seed) {
+        for (int i = 0; i < AIWeights::COUNT; ++i) {
+            scale[i] = std::max(5.0, std::abs(static_cast<double>(start.values[i])));
+            theta[i] = start.values[i] / scale[i];
+        }
+    }
+
+    // Returns the tuned weights, or the start weights if the tuned ones do
+    // not beat them in the verification match.
+    AIWeights run() {
+        const double stability = config.iterations / 10.0;
+        uint64_t seed = config.seed;
+
+        for (int k = 0; k < config.iterations; ++k) {
+            double a = config.learningRate / std::pow(k + 1 + stability, 0.602);
+            double c = config.perturbation / std::pow(k + 1, 0.101);
+
+            double delta[AIWeights::COUNT];
+            double plus[AIWeights::COUNT];
+            double minus[AIWeights::COUNT];
+            for (int i = 0; i < AIWeights::COUNT; ++i) {
+                delta[i] = (rng() & 1) ? 1.0 : -1.0;
+                plus[i] = theta[i] + c * delta[i];
+                minus[i] = theta[i] - c * delta[i];
+            }
+
+            double score = matchScore(toWeights(plus), toWeights(minus), seed, config.games);
+            seed += config.games;
+            for (int i = 0; i < AIWeights::COUNT; ++i) {
+                theta[i] += a * (2.0 * score - 1.0) / (2.0 * c * delta[i]);
+            }
+
+            std::cout << "iteration " << k + 1 << "/" << config.iterations << "  plus-vs-minus " << score;
+            AIWeights current = toWeights(theta);
+            for (int i = 0; i < AIWeights::COUNT; ++i) {
+                std::cout << " " << current.values[i];
+            }
+            std::cout << std::endl;
+        }
+
+        AIWeights tuned = toWeights(theta);
+        verifiedScore = matchScore(tuned, start, seed, config.verifyGames);
+        return verifiedScore > 0.5 ? tuned : start;
+    }
+
+    // Score of the tuned weights against the start weights in the final match.
+    double getVerifiedScore() const { return verifiedScore; }
+
+    // a's share of the points (a draw counts half) over `games` deals, each
+    // played once with a in the player seat and once in the computer seat.
+    double matchScore(const AIWeights& a, const AIWeights& b, uint64_t seed, long long games) const {
+        SelfPlayStats first = play(a, b, seed, games);
+        SelfPlayStats second = play(b, a, seed, games);
+        double points = first.playerWins + second.computerWins + 0.5 * (first.draws + second.draws);
+        long long decided = first.games - first.aborted + second.games - second.aborted;
+        return decided > 0 ? points / decided : 0.5;
+    }
+
+private:
+    TunerConfig config;
+    AIWeights start;
+    std::mt19937_64 rng;
+    double scale[AIWeights::COUNT];
+    double theta[AIWeights::COUNT];
+    double verifiedScore = 0.0;
+
+    AIWeights toWeights(const double* normalized) const {
+        AIWeights weights;
+        for (int i = 0; i < AIWeights::COUNT; ++i) {
+            weights.values[i] = static_cast<int>(std::lround(normalized[i] * scale[i]));
+        }
+        return weights;
+    }
+
+    SelfPlayStats play(const AIWeights& player, const AIWeights& computer, uint64_t seed, long long games) const {
+        SelfPlayConfig selfPlay;
+        selfPlay.games = games;
+        selfPlay.workers = config.workers;
+        selfPlay.seed = seed;
+        selfPlay.playerAIThreads = 1;
+        selfPlay.computerAIThreads = 1;
+        selfPlay.playerEndgameSolver = false;
+        selfPlay.computerEndgameSolver = false;
+        selfPlay.playerWeights = player;
+        selfPlay.computerWeights = computer;
+        return SelfPlayEngine(selfPlay).run();
+    }
+};
@@ -0,0 +1,224 @@
+#include "GameLogic.h"
+#include "GameLog.h"
+#include "SelfPlay.h"
+#include "TableLayout.h"
+#include "HitGrid.h"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Rules, AI and render-prep micro benchmarks. Run with
+// --benchmark_out=FILE --benchmark_out_format=json to keep results.
+
+static const uint64_t BENCH_SEED = 12345;
+
+// Every heap allocation in the process, so benchmarks can report how many a
+// call makes. The AI benchmarks expect 0 per move once warmed up. All forms
+// of new and delete go through the one counted malloc/free pair.
+static std::atomic<long long> heapAllocations{ 0 };
+
+static void* countedAlloc(std::size_t size) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+static void reportAllocations(benchmark::State& state, long long before) {
+    state.counters["allocs/iter"] = benchmark::Counter(static_cast<double>(heapAllocations.load() - before),
+        benchmark::Counter::kAvgIterations);
+}
+
+static void BM_CanBeatCard(benchmark::State& state) {
+    GameLogic gameLogic;
+    gameLogic.setTrumpCard(7);
+    for (auto _ : state) {
+        int beats = 0;
+        for (int attack = 0; attack < CARD_COUNT; ++attack) {
+            for (int defend = 0; defend < CARD_COUNT; ++defend) {
+                beats += gameLogic.canBeatCard(attack, defend);
+            }
+        }
+        benchmark::DoNotOptimize(beats);
+    }
+    state.SetItemsProcessed(state.iterations() * CARD_COUNT * CARD_COUNT);
+}
+BENCHMARK(BM_CanBeatCard);
+
+static void BM_CanAttackWithCard(benchmark::State& state) {
+    GameLogic gameLogic;
+    GameLog::deal(gameLogic, BENCH_SEED);
+    gameLogic.putOnTable(0);
+    gameLogic.putOnTable(13);
+    for (auto _ : state) {
+        int allowed = 0;
+        for (int card = 0; card < CARD_COUNT; ++card) {
+            allowed += gameLogic.canAttackWithCard(card);
+        }
+        benchmark::DoNotOptimize(allowed);
+    }
+    state.SetItemsProcessed(state.iterations() * CARD_COUNT);
+}
+BENCHMARK(BM_CanAttackWithCard);
+
+// Opening sets from a hand holding three of a kind twice plus both jokers.
+static void BM_GenerateAttackMoves(benchmark::State& state) {
+    CardMask hand = 0x00041041u | 0x00082082u | JOKER_MASK;
+    AttackMoveList moves;
+    for (auto _ : state) {
+        generateAttackMoves(hand, 0, MAX_ATTACK_CARDS, moves);
+        benchmark::DoNotOptimize(moves.count);
+    }
+}
+BENCHMARK(BM_GenerateAttackMoves);
+
+// Refills two empty hands from a full deck.
+static void BM_DealCards(benchmark::State& state) {
+    GameLogic gameLogic;
+    for (auto _ : state) {
+        gameLogic.createFullDeck();
+        gameLogic.setPlayerHand(0);
+        gameLogic.setComputerHand(0);
+        gameLogic.dealCards();
+        benchmark::DoNotOptimize(gameLogic.getPlayerHand());
+    }
+}
+BENCHMARK(BM_DealCards);
+
+// Args: attack (1) or defend (0), AI threads.
+static void BM_CalculateAIMove(benchmark::State& state) {
+    bool isAttackTurn = state.range(0) != 0;
+    int numThreads = static_cast<int>(state.range(1));
+
+    GameLogic gameLogic;
+    gameLogic.setEndgameSolver(false);
+    GameLog::deal(gameLogic, BENCH_SEED);
+    if (!isAttackTurn) {
+        gameLogic.playerAttack(0);
+    }
+    gameLogic.calculateAIMove(isAttackTurn, numThreads);
+
+    long long allocations = heapAllocations.load();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(gameLogic.calculateAIMove(isAttackTurn, numThreads));
+    }
+    reportAllocations(state, allocations);
+}
+BENCHMARK(BM_CalculateAIMove)->ArgNames({ "attack", "threads" })
+    ->Args({ 1, 1 })->Args({ 1, 4 })->Args({ 0, 1 })->Args({ 0, 4 })->UseRealTime();
+
+static void BM_GetTextureName(benchmark::State& state) {
+    int cardId = 0;
+    for (auto _ : state) {
+        std::string name = Card::fromId(cardId).getTextureName("C:/textures/");
+        benchmark::DoNotOptimize(name.data());
+        cardId = (cardId + 1) % CARD_COUNT;
+    }
+}
+BENCHMARK(BM_GetTextureName);
+
+// Args: ISMCTS iterations, AI threads.
+static void BM_ISMCTSMove(benchmark::State& state) {
+    GameLogic gameLogic;
+    gameLogic.setEndgameSolver(false);
+    gameLogic.setAIMode(AIMode::ISMCTS);
+    ISMCTSConfig config;
+    config.iterations = static_cast<int>(state.range(0));
+    gameLogic.setISMCTSConfig(config);
+    GameLog::deal(gameLogic, BENCH_SEED);
+    int numThreads = static_cast<int>(state.range(1));
+    gameLogic.calculateAIMove(true, numThreads);
+
+    long long allocations = heapAllocations.load();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(gameLogic.calculateAIMove(true, numThreads));
+    }
+    reportAllocations(state, allocations);
+}
+BENCHMARK(BM_ISMCTSMove)->ArgNames({ "iterations", "threads" })
+    ->Args({ 1000, 1 })->Args({ 1000, 4 })->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// The placement half of GameTable::render: a full relayout each iteration.
+static void BM_TableLayoutUpdate(benchmark::State& state) {
+    TableLayout layout(1024.0f, 768.0f, 80.0f, 120.0f);
+    int table[4] = { 0, 1, 6, 7 };
+    CardMask hands[2] = { 0x00000F3Cu, 0x00F03000u };
+    int flip = 0;
+    for (auto _ : state) {
+        flip ^= 1;
+        benchmark::DoNotOptimize(layout.update(hands[flip], hands[flip ^ 1], table, 4, 19));
+    }
+}
+BENCHMARK(BM_TableLayoutUpdate);
+
+// Same, when nothing changed since the last frame.
+static void BM_TableLayoutUnchanged(benchmark::State& state) {
+    TableLayout layout(1024.0f, 768.0f, 80.0f, 120.0f);
+    int table[4] = { 0, 1, 6, 7 };
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(layout.update(0x00000F3Cu, 0x00F03000u, table, 4, 19));
+    }
+}
+BENCHMARK(BM_TableLayoutUnchanged);
+
+// A 20-card hand has to overlap to fit the 1024 px window; fails the run if
+// any card of it is laid out off screen.
+static void BM_TableLayoutLargeHand(benchmark::State& state) {
+    TableLayout layout(1024.0f, 768.0f, 80.0f, 120.0f);
+    CardMask hands[2] = { 0x000FFFFFu, 0x00F00000u };
+    int flip = 0;
+    for (auto _ : state) {
+        flip ^= 1;
+        benchmark::DoNotOptimize(layout.update(hands[flip], hands[flip ^ 1], nullptr, 0, 20));
+    }
+
+    for (int i = 0; i < layout.size(); ++i) {
+        if (layout.xs()[i] < 0.0f || layout.xs()[i] + layout.getCardWidth() > 1024.0f) {
+            state.SkipWithError("hand laid out off screen");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_TableLayoutLargeHand);
+
+static void BM_HitGridQuery(benchmark::State& state) {
+    TableLayout layout(1024.0f, 768.0f, 80.0f, 120.0f);
+    int table[4] = { 0, 1, 6, 7 };
+    layout.update(0x00000F3Cu, 0x00F03000u, table, 4, 19);
+    HitGrid hits(1024.0f, 768.0f);
+    hits.build(layout);
+
+    float x = 0.0f;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hits.query(x, 110.0f));
+        x = x < 1024.0f ? x + 7.0f : 0.0f;
+    }
+}
+BENCHMARK(BM_HitGridQuery);
+
+// A whole heuristic-vs-heuristic game, single-threaded AI on both sides.
+static void BM_SelfPlayGame(benchmark::State& state) {
+    SelfPlayConfig config;
+    config.computerAIThreads = 1;
+    config.playerEndgameSolver = false;
+    config.computerEndgameSolver = false;
+    SelfPlayEngine engine(config);
+    GameLogic gameLogic;
+
+    uint64_t seed = BENCH_SEED;
+    for (auto _ : state) {
+        int actions = 0;
+        benchmark::DoNotOptimize(engine.playGame(gameLogic, actions, seed++));
+    }
+}
+BENCHMARK(BM_SelfPlayGame);
+
+BENCHMARK_MAIN();
@@ -6,19 +6,27 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <map>
 #include <AL/al.h>
 #include <AL/alc.h>
 #include <sndfile.hh>
 #include <cstdlib>
 #include <set>
-#include <random>
-#include <thread>
-#include <mutex>
-#include <future>
 #include <algorithm>
+#include <filesystem>
+#include <cstring>
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
+#include "GameLogic.h"
+#include "GameLog.h"
+#include "CardAtlas.h"
+#include "AssetPack.h"
+#include "AssetLoader.h"
+#include "AudioStream.h"
+#include "SoundMixer.h"
+#include "TableLayout.h"
+#include "HitGrid.h"
+#include "Profiler.h"
+#include "GLStateCache.h"
 
 
 const float WINDOW_WIDTH = 1024.0f;
@@ -26,134 +34,117 @@ const float WINDOW_HEIGHT = 768.0f;
 
 const float CARD_WIDTH = 80.0f;
 const float CARD_HEIGHT = 120.0f;
-
-class Card {
-public:
-    enum Suit {
-        SPADES = 0,     
-        HEARTS = 1,         
-        DIAMONDS = 2,       
-        CLUBS = 3,          
-        BLACK = 4,
-        RED = 5
-    };
-
-    enum Rank {
-        TWO = 0,       
-        TEN = 1,      
-        JACK = 2,    
-        QUEEN = 3,   
-        KING = 4,  
-        ACE = 5,      
-        JOKER_RANK = 6 
-    };
-
-    Suit suit;
-    Rank rank;
-    bool isFaceUp; 
-    glm::vec2 position;
-    int id; 
-
-    Card() : suit(SPADES), rank(TWO), isFaceUp(true), position(0.0f, 0.0f), id(-1) {}
-
-    Card(Suit s, Rank r, int cardId) : suit(s), rank(r), isFaceUp(true), id(cardId) {
-        position = glm::vec2(0.0f, 0.0f);
-    }
-
-    std::string getTextureName() const {
-        if (!isFaceUp) {
-            return "C:/textures/card_back.jpg";
-        }
-
-        std::string suitStr;
-        if (suit == SPADES) suitStr = "spades";
-        else if (suit == HEARTS) suitStr = "hearts";
-        else if (suit == DIAMONDS) suitStr = "diamonds";
-        else if (suit == CLUBS) suitStr = "clubs";
-
-        std::string rankStr;
-        if (rank == TWO) rankStr = "2";
-        else if (rank == TEN) rankStr = "10";
-        else if (rank == JACK) rankStr = "jack";
-        else if (rank == QUEEN)  rankStr = "queen";
-        else if (rank == KING) rankStr = "king";
-        else if (rank == ACE) rankStr = "ace";
-        else if (rank == JOKER_RANK) {
-            rankStr = "joker";
-            if (suit == BLACK) suitStr = "black";
-            if (suit == RED) suitStr = "red";
-        }
-
-
-        return "C:/textures/" + rankStr + "_of_" + suitStr + ".png"; 
-    }
-};
-
-enum class GameState {
-    START_GAME = 0,
-    PLAYER_TURN_ATTACK = 1,
-    PLAYER_TURN_DEFEND = 2,
-    COMPUTER_TURN_ATTACK = 3,
-    COMPUTER_TURN_DEFEND = 4,
-    GAME_OVER = 5
+const float HOVER_LIFT = 12.0f;
+
+// Fixed tick for anything that animates; an idle table sleeps up to IDLE_TIMEOUT.
+const double FRAME_INTERVAL = 1.0 / 60.0;
+const double IDLE_TIMEOUT = 0.5;
+
+// Assets are looked up next to the executable: assets.pak (see packassets),
+// or the loose files in textures/ when there is no pack.
+const char* const ASSET_PACK_NAME = "assets.pak";
+const char* const LOOSE_ASSET_DIR = "textures/";
+const char* const MUSIC_TRACK = "The_Void.mp3";
+const char* const GAME_LOG_PATH = "last_game.dlog";
+const char* const PROFILE_TRACE_PATH = "profile_trace.json";
+const char* const AI_WEIGHTS_PATH = "ai_weights.txt";
+
+enum SoundEffect {
+    SOUND_CARD_PLAY = 0,
+    SOUND_CARD_BEAT = 1,
+    SOUND_TAKE_CARDS = 2,
+    SOUND_EFFECT_COUNT = 3
 };
 
+const char* const SOUND_EFFECT_FILES[SOUND_EFFECT_COUNT] = { "card_play.wav", "card_beat.wav", "take_cards.wav" };
 
+// Owns the game's two textures, the card atlas and the table background.
+// Each is uploaded once; later calls return the existing handle.
 class TextureManager {
 private:
-    std::map<std::string, unsigned int> textures;
+    unsigned int cardAtlas = 0;
+    unsigned int background = 0;
 
 public:
     ~TextureManager() {
-        for (auto& pair : textures) {
-            glDeleteTextures(1, &pair.second);
-        }
+        if (cardAtlas) glDeleteTextures(1, &cardAtlas);
+        if (background) glDeleteTextures(1, &background);
     }
 
-    unsigned int loadTexture(const std::string& filename) {
-        stbi_set_flip_vertically_on_load(true);
-        if (textures.find(filename) != textures.end()) {
-            return textures[filename];
-        }
+    // Uploads the table image decoded by the AssetLoader.
+    unsigned int loadBackground(const DecodedImage& image) {
+        if (background) return background;
+        if (!image.pixels) return 0;
 
-        unsigned int textureID;
-        glGenTextures(1, &textureID);
+        GLenum format = GL_RGBA;
+        if (image.channels == 1)
+            format = GL_RED;
+        else if (image.channels == 3)
+            format = GL_RGB;
 
-        int width, height, nrChannels;
-        unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrChannels, 0);
+        glGenTextures(1, &background);
+        uploadTexture(background, format, image.width, image.height, image.pixels, GL_REPEAT);
+        return background;
+    }
 
-        if (data) {
-            GLenum format;
-            if (nrChannels == 1)
-                format = GL_RED;
-            else if (nrChannels == 3)
-                format = GL_RGB;
-            else if (nrChannels == 4)
-                format = GL_RGBA;
+    // Uploads the packed card atlas as a single texture. A compressed atlas
+    // goes up with the mip levels it shipped with. Returns 0 if there is
+    // nothing to upload or the driver lacks S3TC.
+    unsigned int loadCardAtlas(const CardAtlas& atlas) {
+        if (cardAtlas) return cardAtlas;
+        if (atlas.isEmpty()) return 0;
+        if (atlas.isCompressed() && !supportsS3tc()) {
+            std::cout << "S3TC texture compression is not supported" << std::endl;
+            return 0;
+        }
 
-            glBindTexture(GL_TEXTURE_2D, textureID);
+        glGenTextures(1, &cardAtlas);
+        if (atlas.isCompressed()) {
+            uploadCompressed(cardAtlas, atlas.getCompressed(), GL_CLAMP_TO_EDGE);
+        }
+        else {
+            uploadTexture(cardAtlas, GL_RGBA, atlas.getWidth(), atlas.getHeight(), atlas.getPixels(), GL_CLAMP_TO_EDGE);
+        }
+        return cardAtlas;
+    }
 
-            glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-            glGenerateMipmap(GL_TEXTURE_2D);
+private:
+    // The S3TC formats are an extension even in core profiles.
+    static bool supportsS3tc() {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; ++i) {
+            const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (extension && std::strcmp(extension, "GL_EXT_texture_compression_s3tc") == 0) return true;
+        }
+        return false;
+    }
 
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    void uploadTexture(unsigned int textureID, GLenum format, int width, int height, const unsigned char* data, GLint wrap) {
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-            textures[filename] = textureID;
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        setSampling(wrap);
+    }
 
-            std::cout << "Successfully loaded texture: " << filename << std::endl;
-        }
-        else {
-            std::cout << "Failed to load texture: " << filename << std::endl;
-            std::cout << "STB error: " << stbi_failure_reason() << std::endl;
-            glDeleteTextures(1, &textureID); 
-            textureID = 0; 
+    void uploadCompressed(unsigned int textureID, const CompressedTexture& texture, GLint wrap) {
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        for (size_t i = 0; i < texture.levels.size(); ++i) {
+            const CompressedTexture::Level& level = texture.levels[i];
+            glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), texture.format, level.width, level.height, 0,
+                static_cast<GLsizei>(level.size), level.data);
         }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(texture.levels.size()) - 1);
+        setSampling(wrap);
+    }
 
-        stbi_image_free(data);
-        return textureID;
+    void setSampling(GLint wrap) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     }
 };
 
@@ -197,13 +188,45 @@ static unsigned int createShaderProgram(const char* vertexSource, const char* fr
 }
 
 
+struct CardInstance {
+    float x, y, width, height;
+    float u0, v0, u1, v1;
+};
+
+struct RenderStats {
+    int drawCalls = 0;
+    int stateChanges = 0;
+    int skippedStateChanges = 0;
+    int cards = 0;
+};
+
+struct OverlayVertex {
+    float x, y;
+    float r, g, b, a;
+};
+
 class Renderer {
 private:
-    unsigned int cardVAO, cardVBO, cardEBO;
+    unsigned int cardVAO, cardVBO, cardEBO, cardInstanceVBO;
     unsigned int cardShaderProgram;
+    int cardProjectionLocation;
+    int cardInstanceCapacity = 0;
     unsigned int backgroundVAO, backgroundVBO, backgroundEBO;
     unsigned int backgroundShaderProgram;
     TextureManager textureManager;
+    GLStateCache glState;
+    AtlasRect cardRects[CardAtlas::SLOT_COUNT] = {};
+    unsigned int cardAtlasTexture = 0;
+    unsigned int backgroundTexture = 0;
+    RenderStats stats;
+
+    std::vector<CardInstance> queuedCards;
+
+    unsigned int overlayVAO = 0, overlayVBO = 0;
+    unsigned int overlayShaderProgram = 0;
+    int overlayProjectionLocation = -1;
+    int overlayCapacity = 0;
+    std::vector<OverlayVertex> overlayVertices;
 
     float cardVertices[20] = {
         // pos(x,y,z)     // tex coords
@@ -219,6 +242,22 @@ public:
     void init() {
         initCardRendering();
         initBackgroundRendering();
+#ifdef CARDGAME_PROFILING
+        initOverlayRendering();
+#endif
+        glState.invalidate();
+    }
+
+    // Takes the decoded startup assets and resolves every texture handle up
+    // front. False if the card atlas could not be uploaded.
+    bool uploadAssets(const CardAtlas& cardAtlas, const DecodedImage& background) {
+        for (int slot = 0; slot < CardAtlas::SLOT_COUNT; ++slot) {
+            cardRects[slot] = cardAtlas.getRect(slot);
+        }
+        cardAtlasTexture = textureManager.loadCardAtlas(cardAtlas);
+        backgroundTexture = textureManager.loadBackground(background);
+        glState.invalidate();
+        return cardAtlasTexture != 0;
     }
 
 private:
@@ -238,16 +277,27 @@ private:
         glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
         glEnableVertexAttribArray(1);
 
+        glGenBuffers(1, &cardInstanceVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, cardInstanceVBO);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(CardInstance), (void*)0);
+        glEnableVertexAttribArray(2);
+        glVertexAttribDivisor(2, 1);
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(CardInstance), (void*)(4 * sizeof(float)));
+        glEnableVertexAttribArray(3);
+        glVertexAttribDivisor(3, 1);
+
         const char* cardVertexShader = R"(
         #version 330 core
         layout (location = 0) in vec3 aPos;
         layout (location = 1) in vec2 aTexCoord;
+        layout (location = 2) in vec4 aRect;
+        layout (location = 3) in vec4 aUV;
         out vec2 TexCoord;
-        uniform mat4 model;
         uniform mat4 projection;
         void main() {
-            gl_Position = projection * model * vec4(aPos, 1.0);
-            TexCoord = aTexCoord;
+            vec2 pos = aRect.xy + (aPos.xy + 0.5) * aRect.zw;
+            gl_Position = projection * vec4(pos, 0.0, 1.0);
+            TexCoord = mix(aUV.xy, aUV.zw, aTexCoord);
         })";
 
         const char* cardFragmentShader = R"(
@@ -260,6 +310,7 @@ private:
         })";
 
         cardShaderProgram = createShaderProgram(cardVertexShader, cardFragmentShader);
+        cardProjectionLocation = glGetUniformLocation(cardShaderProgram, "projection");
     }
 
     void initBackgroundRendering() {
@@ -309,611 +360,213 @@ private:
         backgroundShaderProgram = createShaderProgram(backgroundVertexShader, backgroundFragmentShader);
     }
 
+    // Flat-coloured rectangles for the profiler overlay.
+    void initOverlayRendering() {
+        glGenVertexArrays(1, &overlayVAO);
+        glGenBuffers(1, &overlayVBO);
 
-public:
-    void renderCard(const Card& card, const glm::mat4& projection) {
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(
-            card.position.x + CARD_WIDTH / 2,
-            card.position.y + CARD_HEIGHT / 2,
-            0.0f
-        ));
-        model = glm::scale(model, glm::vec3(CARD_WIDTH, CARD_HEIGHT, 1.0f));
-
-        glUseProgram(cardShaderProgram);
-
-        unsigned int modelLoc = glGetUniformLocation(cardShaderProgram, "model");
-        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-
-        unsigned int projLoc = glGetUniformLocation(cardShaderProgram, "projection");
-        glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-
-        unsigned int texture = textureManager.loadTexture(card.getTextureName());
-        if (texture != 0) {
-            glBindTexture(GL_TEXTURE_2D, texture);
-        }
-
-        glBindVertexArray(cardVAO);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    }
+        glBindVertexArray(overlayVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, overlayVBO);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(OverlayVertex), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(OverlayVertex), (void*)(2 * sizeof(float)));
+        glEnableVertexAttribArray(1);
 
-    void renderCards(const std::vector<Card>& cards, const glm::mat4& projection) {
-        for (int i = 0; i < cards.size(); ++i) {
-            renderCard(cards[i], projection);
-        }
-    }
+        const char* overlayVertexShader = R"(
+        #version 330 core
+        layout (location = 0) in vec2 aPos;
+        layout (location = 1) in vec4 aColor;
+        out vec4 Color;
+        uniform mat4 projection;
+        void main() {
+            gl_Position = projection * vec4(aPos, 0.0, 1.0);
+            Color = aColor;
+        })";
 
-    void renderBackground(const std::string& texturePath) {
-        unsigned int texture = textureManager.loadTexture(texturePath);
-        if (texture == 0) return;
+        const char* overlayFragmentShader = R"(
+        #version 330 core
+        out vec4 FragColor;
+        in vec4 Color;
+        void main() {
+            FragColor = Color;
+        })";
 
-        glUseProgram(backgroundShaderProgram);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glBindVertexArray(backgroundVAO);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        overlayShaderProgram = createShaderProgram(overlayVertexShader, overlayFragmentShader);
+        overlayProjectionLocation = glGetUniformLocation(overlayShaderProgram, "projection");
     }
-};
 
 
-class AudioManager { 
-    ALCdevice* device;
-    ALCcontext* context;
-    ALuint buffer;
-    ALuint source;
 public:
-    AudioManager() {
-        device = alcOpenDevice(nullptr);
-        context = alcCreateContext(device, nullptr);
-        buffer = 0;
-        source = 0;
-        alcMakeContextCurrent(context);
-    };
-    ~AudioManager() {
-        alcDestroyContext(context);
-        alcCloseDevice(device);
-    }
-    ALuint loadAudio(const std::string& filePath) {
-        SF_INFO fileInfo;
-        SNDFILE* file = sf_open(filePath.c_str(), SFM_READ, &fileInfo);
-        if (!file) {
-            std::cerr << "Failed to open audio file: " << filePath << std::endl;
-            return 0;
+    // Queues every card of the layout, in its draw order; liftedCard (a layout
+    // index, or -1) is drawn slightly raised, e.g. under the cursor.
+    void queueLayout(const TableLayout& layout, int liftedCard) {
+        const float* xs = layout.xs();
+        const float* ys = layout.ys();
+        const int* ids = layout.cardIds();
+        const bool* faceUp = layout.faceUps();
+        for (int i = 0; i < layout.size(); ++i) {
+            const AtlasRect& uv = cardRects[CardAtlas::slotFor(ids[i], faceUp[i])];
+            float y = i == liftedCard ? ys[i] + HOVER_LIFT : ys[i];
+            queuedCards.push_back({ xs[i], y, layout.getCardWidth(), layout.getCardHeight(), uv.u0, uv.v0, uv.u1, uv.v1 });
         }
-
-        std::vector<short> audioData(fileInfo.frames * fileInfo.channels);
-        sf_readf_short(file, audioData.data(), fileInfo.frames);
-        sf_close(file);
-
-        ALuint buffer;
-        alGenBuffers(1, &buffer);
-        alBufferData(buffer, fileInfo.channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16,
-            audioData.data(), static_cast<ALsizei>(audioData.size() * sizeof(short)), static_cast<ALsizei>(fileInfo.samplerate));
-
-        return buffer;
     }
-    ;
-    ALuint playAudio(ALuint buffer) {
-        ALuint source;
-        alGenSources(1, &source);
-        alSourcei(source, AL_BUFFER, buffer);
-        alSourcePlay(source);
-        return source;
-    };
 
-    void stopAudio(ALuint source) {
-        alSourceStop(source);
-    }
-    void setVolume(ALuint source, float volume) {
-        alSourcef(source, AL_GAIN, volume);
-    };
-};
+    // Draws every queued card, all from the card atlas, with one instanced
+    // draw in queue order.
+    void renderCards(const glm::mat4& projection) {
+        int count = static_cast<int>(queuedCards.size());
+        if (count == 0) return;
 
-class GameLogic {
-private:
-    std::mt19937 rng;
-    std::vector<Card> Deck;
-    std::vector<Card> playerCards;
-    std::vector<Card> computerCards;
-    std::vector<Card> tableCards; 
-    Card trumpCard; 
-    std::mutex aiMutex;
-
-    int calculateSimpleAIMove(bool isAttackTurn) {
-        if (isAttackTurn) {
-            return findBestAttackCard();
+        glState.bindArrayBuffer(cardInstanceVBO);
+        if (count > cardInstanceCapacity) {
+            cardInstanceCapacity = std::max(count, 64);
+            glBufferData(GL_ARRAY_BUFFER, cardInstanceCapacity * sizeof(CardInstance), nullptr, GL_STREAM_DRAW);
         }
-        else {
-            return findBestDefenseCard();
-        }
-    }
-
-    int calculateMultiThreadAIMove(bool isAttackTurn, int numThreads) {
-        std::vector<std::future<int>> futures;
-        std::vector<int> results;
-
-        if (isAttackTurn) {
-            int cardsPerThread = std::max(1, (int)computerCards.size() / numThreads);
-
-            for (int i = 0; i < numThreads; ++i) {
-                int startIdx = i * cardsPerThread;
-                int endIdx = std::min((i + 1) * cardsPerThread, (int)computerCards.size());
-
-                if (startIdx >= endIdx) break;
+        glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(CardInstance), queuedCards.data());
 
-                futures.push_back(std::async(std::launch::async, [this, startIdx, endIdx]() {
-                    return findBestAttackCardInRange(startIdx, endIdx);
-                    }));
-            }
-        }
-        else {
-            futures.push_back(std::async(std::launch::async, [this]() {
-                return findMinimalDefenseCard();
-                }));
+        glState.useProgram(cardShaderProgram);
+        glState.setUniformMatrix4(cardProjectionLocation, glm::value_ptr(projection));
+        glState.bindVertexArray(cardVAO);
+        glState.bindTexture(cardAtlasTexture);
+        glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, count);
+        stats.drawCalls++;
 
-            futures.push_back(std::async(std::launch::async, [this]() {
-                return findStrategicDefenseCard();
-                }));
-        }
-
-        for (auto& future : futures) {
-            int result = future.get();
-            if (result != -1) {
-                results.push_back(result);
-            }
-        }
-
-        if (results.empty()) return -1;
-        return selectBestMove(results, isAttackTurn);
+        stats.cards += count;
+        queuedCards.clear();
     }
 
-    int findBestAttackCard() {
-        int bestCardIndex = -1;
-        int bestScore = INT_MIN;
-
-        for (int i = 0; i < computerCards.size(); ++i) {
-            if (canAttackWithCard(computerCards[i])) {
-                int score = evaluateAttackCard(computerCards[i], i);
-                if (score > bestScore) {
-                    bestScore = score;
-                    bestCardIndex = i;
-                }
-            }
-        }
-
-        return bestCardIndex;
-    }
-
-    int findBestAttackCardInRange(int startIdx, int endIdx) {
-        int bestCardIndex = -1;
-        int bestScore = INT_MIN;
-
-        for (int i = startIdx; i < endIdx; ++i) {
-            if (canAttackWithCard(computerCards[i])) {
-                int score = evaluateAttackCard(computerCards[i], i);
-                if (score > bestScore) {
-                    bestScore = score;
-                    bestCardIndex = i;
-                }
-            }
-        }
-
-        return bestCardIndex;
-    }
-
-    int findBestDefenseCard() {
-        if (tableCards.empty()) return -1;
-
-        Card attackCard = tableCards.back();
-        int bestCardIndex = -1;
-        int bestScore = INT_MIN;
-
-        for (int i = 0; i < computerCards.size(); ++i) {
-            if (canBeatCard(attackCard, computerCards[i], trumpCard)) {
-                int score = evaluateDefenseCard(computerCards[i], attackCard, i);
-                if (score > bestScore) {
-                    bestScore = score;
-                    bestCardIndex = i;
-                }
-            }
-        }
-
-        return bestCardIndex;
-    }
-
-    int findMinimalDefenseCard() {
-        if (tableCards.empty()) return -1;
-
-        Card attackCard = tableCards.back();
-        int bestCardIndex = -1;
-        int minValue = INT_MAX;
-
-        for (int i = 0; i < computerCards.size(); ++i) {
-            if (canBeatCard(attackCard, computerCards[i], trumpCard)) {
-                int value = getCardValue(computerCards[i]);
-                if (value < minValue) {
-                    minValue = value;
-                    bestCardIndex = i;
-                }
-            }
-        }
-
-        return bestCardIndex;
-    }
-
-    int findStrategicDefenseCard() {
-        if (tableCards.empty()) return -1;
-
-        Card attackCard = tableCards.back();
-        int bestCardIndex = -1;
-        int bestScore = INT_MIN;
-
-        for (int i = 0; i < computerCards.size(); ++i) {
-            if (canBeatCard(attackCard, computerCards[i], trumpCard)) {
-                int score = evaluateStrategicDefense(computerCards[i], attackCard, i);
-                if (score > bestScore) {
-                    bestScore = score;
-                    bestCardIndex = i;
-                }
-            }
-        }
-
-        return bestCardIndex;
+    void queueOverlayRect(float x0, float y0, float x1, float y1, float r, float g, float b, float a) {
+        OverlayVertex corners[4] = {
+            { x0, y0, r, g, b, a }, { x1, y0, r, g, b, a }, { x1, y1, r, g, b, a }, { x0, y1, r, g, b, a }
+        };
+        const int order[6] = { 0, 1, 2, 0, 2, 3 };
+        for (int i : order) overlayVertices.push_back(corners[i]);
     }
 
-    int evaluateAttackCard(const Card& card, int index) {
-        int score = 0;
-        score -= getCardValue(card) * 2; 
+    // Draws every queued overlay rectangle in one call, on top of the table.
+    void renderOverlay(const glm::mat4& projection) {
+        int count = static_cast<int>(overlayVertices.size());
+        if (count == 0 || overlayShaderProgram == 0) return;
 
-        if (card.suit != trumpCard.suit) {
-            score += 50;
+        glState.bindArrayBuffer(overlayVBO);
+        if (count > overlayCapacity) {
+            overlayCapacity = std::max(count, 1024);
+            glBufferData(GL_ARRAY_BUFFER, overlayCapacity * sizeof(OverlayVertex), nullptr, GL_STREAM_DRAW);
         }
+        glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(OverlayVertex), overlayVertices.data());
 
-        if (card.suit == trumpCard.suit) {
-            score -= 30;
-        }
-
-        return score;
+        glState.useProgram(overlayShaderProgram);
+        glState.setUniformMatrix4(overlayProjectionLocation, glm::value_ptr(projection));
+        glState.bindVertexArray(overlayVAO);
+        glDrawArrays(GL_TRIANGLES, 0, count);
+        stats.drawCalls++;
+        overlayVertices.clear();
     }
 
-    int evaluateDefenseCard(const Card& card, const Card& attackCard, int index) {
-        int score = 0;
-
-        score -= getCardValue(card) * 3;
-
-        if (card.suit == trumpCard.suit && hasNonTrumpAlternative(attackCard)) {
-            score -= 40;
-        }
-
-        if (card.suit == trumpCard.suit && !hasNonTrumpAlternative(attackCard)) {
-            score += 30;
-        }
-
-        if (getCardValue(card) > 10) {
-            score -= 25;
-        }
-
-        return score;
+    void resetStats() {
+        stats = RenderStats();
+        glState.resetCounts();
     }
 
-    int evaluateStrategicDefense(const Card& card, const Card& attackCard, int index) {
-        int score = 0;
-
-        score -= getCardValue(card);
-
-        if (card.suit == trumpCard.suit && hasNonTrumpAlternative(attackCard)) {
-            score -= 100;
-        }
-
-        if (card.suit == attackCard.suit) {
-            score += 20;
-        }
-
-        return score;
+    // Adds the calls the state cache issued and skipped to the counts kept here.
+    RenderStats getStats() const {
+        RenderStats current = stats;
+        current.stateChanges += glState.getIssued();
+        current.skippedStateChanges = glState.getSkipped();
+        return current;
     }
 
-    int selectBestMove(const std::vector<int>& candidateIndices, bool isAttackTurn) {
-        if (candidateIndices.empty()) return -1;
-        if (candidateIndices.size() == 1) return candidateIndices[0];
-
-        if (isAttackTurn) {
-            int bestIndex = candidateIndices[0];
-            int minValue = getCardValue(computerCards[bestIndex]);
+    void renderBackground() {
+        if (backgroundTexture == 0) return;
 
-            for (int i = 1; i < candidateIndices.size(); ++i) {
-                int value = getCardValue(computerCards[candidateIndices[i]]);
-                if (value < minValue) {
-                    minValue = value;
-                    bestIndex = candidateIndices[i];
-                }
-            }
-            return bestIndex;
-        }
-
-        int bestIndex = candidateIndices[0];
-        int bestScore = evaluateDefenseCard(computerCards[bestIndex], tableCards.back(), bestIndex);
-
-        for (int i = 1; i < candidateIndices.size(); ++i) {
-            int score = evaluateDefenseCard(computerCards[candidateIndices[i]], tableCards.back(), candidateIndices[i]);
-            if (score > bestScore) {
-                bestScore = score;
-                bestIndex = candidateIndices[i];
-            }
-        }
-
-        return bestIndex;
+        glState.useProgram(backgroundShaderProgram);
+        glState.bindTexture(backgroundTexture);
+        glState.bindVertexArray(backgroundVAO);
+        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        stats.drawCalls++;
     }
+};
 
-    bool hasNonTrumpAlternative(const Card& attackCard) {
-        for (const auto& card : computerCards) {
-            if (card.suit != trumpCard.suit &&
-                canBeatCard(attackCard, card, trumpCard)) {
-                return true;
-            }
-        }
-        return false;
-    }
 
+class AudioManager { 
+    ALCdevice* device;
+    ALCcontext* context;
+    AudioStream music;
+    SoundMixer effects;
 public:
-    GameLogic() : rng(std::random_device{}()), Deck(), playerCards(),
-        computerCards(), tableCards(), trumpCard(), aiMutex() {
-    }
-
-    std::vector<Card> createFullDeck() {
-        int id = 0;
-
-        for (int suit = 0; suit < 4; ++suit) {
-            for (int rank = 0; rank < 6; ++rank) { 
-                Deck.emplace_back(static_cast<Card::Suit>(suit),
-                    static_cast<Card::Rank>(rank), id++);
-            }
-        }
-
-        Deck.emplace_back(Card::BLACK, Card::JOKER_RANK, id++);
-        Deck.emplace_back(Card::RED, Card::JOKER_RANK, id++);
-
-        return Deck;
-    }
-
-    void shuffleDeck(std::vector<Card>& Deck) {
-        std::shuffle(Deck.begin(), Deck.end(), rng);
-    }
-
-    void firstdealCards(std::vector<Card>& Deck) {
-        playerCards.clear();
-        computerCards.clear();
-
-        for (int i = 0; i < 6; ++i) {
-            if (!Deck.empty()) {
-                playerCards.push_back(Deck.back());
-                Deck.pop_back();
-            }
-            if (!Deck.empty()) {
-                computerCards.push_back(Deck.back());
-                Deck.pop_back();
-            }
-        }
-
-        if (!Deck.empty()) {
-            while (Deck.back().rank == 6)
-                shuffleDeck(Deck);
-            Card trump = Deck.back();
-            Deck.pop_back();
-            trumpCard = trump;
-        }
-    }
-
-    void dealCards(std::vector<Card>& Deck) {
-        while (playerCards.size() < 6 && computerCards.size() < 6 && !Deck.empty()) {
-            playerCards.push_back(Deck.back());
-            Deck.pop_back();
-            computerCards.push_back(Deck.back());
-            Deck.pop_back();
-        }
-
-        while (playerCards.size() < 6 && !Deck.empty()) {
-            playerCards.push_back(Deck.back());
-            Deck.pop_back();
-        }
-
-        while (computerCards.size() < 6 && !Deck.empty()) {
-            computerCards.push_back(Deck.back());
-            Deck.pop_back();
-        }
-    }
-
-    bool canBeatCard(const Card& attackCard, const Card& defendCard, const Card& trumpCard) {
-        if (defendCard.rank == Card::JOKER_RANK) {
-            return true;
-        }
-
-        if (attackCard.rank == Card::JOKER_RANK) {
-            return defendCard.rank == Card::JOKER_RANK;
-        }
-
-        if (defendCard.suit == trumpCard.suit) {
-            if (attackCard.suit != trumpCard.suit) {
-                return true;
-            }
-            else {
-                return getCardValue(defendCard) > getCardValue(attackCard);
-            }
-        }
-
-        else if (attackCard.suit == defendCard.suit) {
-            return getCardValue(defendCard) > getCardValue(attackCard);
-        }
-
-        return false;
-    }
-
-    int getCardValue(const Card& card) {
-        if (card.rank == Card::JOKER_RANK) return 100;
-
-        switch (card.rank) {
-        case Card::TWO: return 2;
-        case Card::TEN: return 10;
-        case Card::JACK: return 11;
-        case Card::QUEEN: return 12;
-        case Card::KING: return 13;
-        case Card::ACE: return 14;
-        default: return 1;
-        }
-    }
-
-    bool playerAttack(int cardIndex) {
-        if (cardIndex < 0 || cardIndex >= static_cast<int>(playerCards.size())) {
-            return false;
-        }
-
-        if (tableCards.empty() || canAttackWithCard(playerCards[cardIndex])) {
-            Card attackingCard = playerCards[cardIndex];
-            attackingCard.id = cardIndex;
-
-            tableCards.push_back(attackingCard);
-            playerCards.erase(playerCards.begin() + cardIndex);
-
-            return true;
-        }
-
-        return false;
-    }
-
-    bool canAttackWithCard(const Card& card) {
-        if (tableCards.empty()) return true; 
-
-        for (const auto& tableCard : tableCards) {
-            if (tableCard.rank == card.rank) {
-                return true;
-            }
-        }
-
-        return false;
-    }
-
-    bool playerDefend(int attackCardIndex, int defendCardIndex) {
-
-        if (attackCardIndex < 0 || attackCardIndex >= static_cast<int>(tableCards.size()) ||
-            defendCardIndex < 0 || defendCardIndex >= static_cast<int>(playerCards.size())) {
-            return false;
-        }
-
-        Card& attackCard = tableCards[attackCardIndex];
-        Card& defendCard = playerCards[defendCardIndex];
-
-        if (canBeatCard(attackCard, defendCard, trumpCard)) {
-            attackCard.isFaceUp = false;
-            tableCards.push_back(defendCard);
-            playerCards.erase(playerCards.begin() + defendCardIndex);
-
-            return true;
-        }
-
-        return false;
+    AudioManager() {
+        device = alcOpenDevice(nullptr);
+        context = alcCreateContext(device, nullptr);
+        alcMakeContextCurrent(context);
+        effects.init();
+    };
+    ~AudioManager() {
+        music.stop();
+        effects.shutdown();
+        alcDestroyContext(context);
+        alcCloseDevice(device);
     }
 
-    bool isGameOver() {
-        return playerCards.empty() || computerCards.empty();
+    // Caches a decoded clip under soundId; playEffect() never touches the disk.
+    bool loadEffect(int soundId, const DecodedAudio& audio) {
+        return effects.loadSound(soundId, audio);
     }
 
-    std::string getWinner() {
-
-        if (playerCards.empty() && computerCards.empty()) {
-            return "draw!";
-        }
-        else if (playerCards.empty()) {
-            return "Player wins!";
-        }
-        else if (computerCards.empty()) {
-            return "Computer wins!";
-        }
-
-        return "Continue game";
+    void playEffect(int soundId, int priority) {
+        effects.play(soundId, priority);
     }
 
-    int calculateAIMove(bool isAttackTurn, int numThreads = 2) {
-        if (computerCards.empty()) return -1;
-
-        if (numThreads <= 1 || computerCards.size() <= 2) {
-            return calculateSimpleAIMove(isAttackTurn);
-        }
-
-        return calculateMultiThreadAIMove(isAttackTurn, numThreads);
+    // Streams a music track instead of decoding it into one buffer.
+    void playMusic(const std::string& filePath, bool loop) {
+        music.play(filePath, loop);
     }
 
-    void computergettablecards() {
-        while (tableCards.size() > 0) {
-            computerCards.push_back(tableCards.back());
-            tableCards.pop_back();
-        }
+    void playMusic(const AssetView& track, bool loop) {
+        music.play(track, loop);
     }
 
-    void playergettablecards() {
-        while (tableCards.size() > 0) {
-            playerCards.push_back(tableCards.back());
-            tableCards.pop_back();
-        }
+    void stopMusic() {
+        music.stop();
     }
 
-    void freetablecards() {
-        while (tableCards.size() > 0)
-            tableCards.pop_back();
+    void setMusicVolume(float volume) {
+        music.setVolume(volume);
     }
-
-    std::vector<Card>& getPlayerCards() { return playerCards; }
-    std::vector<Card>& getDeck() { return Deck; }
-    std::vector<Card>& getComputerCards() { return computerCards; }
-    std::vector<Card>& getTableCards() { return tableCards; }
-    Card& getTrumpCard() { return trumpCard; }
-    int getsize(std::vector<Card>& vec) { return vec.size(); }
-
-
-    void setPlayerCards(const std::vector<Card>& cards) { playerCards = cards; }
-    void setComputerCards(const std::vector<Card>& cards) { computerCards = cards; }
-    void setTableCards(const std::vector<Card>& cards) { tableCards = cards; }
-    void setTrumpCard(const Card& card) { trumpCard = card; }
-
 };
 
 class MouseManager {
 private:
     int selectedCardIndex = -1;
+    HitResult hovered = { -1, -1 };
 public:
     MouseManager() : selectedCardIndex(-1) {}
 
-    int getCardAtPosition(double xpos, double ypos, std::vector<Card> playercards) {
-        ypos = WINDOW_HEIGHT - ypos;
-
-        for (int i = playercards.size() - 1; i >= 0; --i) {
-            if (i >= 6) continue;
-
-            const Card& card = playercards[i];
-
-            if (xpos >= card.position.x &&
-                xpos <= card.position.x + CARD_WIDTH &&
-                ypos >= card.position.y &&
-                ypos <= card.position.y + CARD_HEIGHT) {
-                return i;
-            }
-        }
-
-        if (xpos >= 0.0f && xpos <= 100.0f &&
-            ypos >= 0.0f && ypos <= 100.0f) {
-            return -2;
-        }
-
-        if (WINDOW_WIDTH - xpos >= 0.0f && WINDOW_WIDTH - xpos <= 100.0f && WINDOW_HEIGHT - ypos >= 0.0f && WINDOW_HEIGHT - ypos <= 100.0f) {
-            return -3;
-        }
-
+    // Index of the player's card under the cursor, -2 / -3 for the end-attack
+    // and take corners, -1 for anything else.
+    int getCardAtPosition(double xpos, double ypos, const HitGrid& hits) {
+        HitResult hit = hits.query(static_cast<float>(xpos), static_cast<float>(WINDOW_HEIGHT - ypos));
+        if (hit.zone == TableLayout::ZONE_PLAYER_HAND) return hit.index;
+        if (hit.zone == HitGrid::ZONE_END_ATTACK) return -2;
+        if (hit.zone == HitGrid::ZONE_TAKE) return -3;
         return -1;
     }
 
-    void onMouseClick(double xpos, double ypos, std::vector<Card> playercards) {
-        int clickedCardIndex = getCardAtPosition(xpos, ypos, playercards);
+    // Returns true if the cursor moved onto a different region.
+    bool onMouseMove(double xpos, double ypos, const HitGrid& hits) {
+        HitResult hit = hits.query(static_cast<float>(xpos), static_cast<float>(WINDOW_HEIGHT - ypos));
+        if (hit.zone == hovered.zone && hit.index == hovered.index) return false;
+        hovered = hit;
+        return true;
+    }
+
+    const HitResult& getHovered() const { return hovered; }
+
+    void onMouseClick(double xpos, double ypos, const HitGrid& hits, const TableLayout& layout) {
+        int clickedCardIndex = getCardAtPosition(xpos, ypos, hits);
         if (clickedCardIndex >= 0) {
             std::cout << "Click on card #" << clickedCardIndex << std::endl;
             selectedCardIndex = clickedCardIndex;
-            onCardSelected(clickedCardIndex, playercards);
+            onCardSelected(clickedCardIndex, layout);
         }
         else if (clickedCardIndex == -2) {
             selectedCardIndex = -2;
@@ -929,9 +582,10 @@ public:
         }
     }
 
-    void onCardSelected(int cardIndex, std::vector<Card> playercards) {
-        if (cardIndex >= 0 && cardIndex < static_cast<int>(playercards.size())) {
-            std::cout << "Chosen card: " << playercards[cardIndex].getTextureName() << std::endl;
+    void onCardSelected(int cardIndex, const TableLayout& layout) {
+        int handBegin = layout.zoneBegin(TableLayout::ZONE_PLAYER_HAND);
+        if (cardIndex >= 0 && cardIndex < layout.zoneEnd(TableLayout::ZONE_PLAYER_HAND) - handBegin) {
+            std::cout << "Chosen card: " << Card::fromId(layout.cardIds()[handBegin + cardIndex]).getTextureName() << std::endl;
         }
     }
 
@@ -958,79 +612,109 @@ public:
         renderer.init();
     }
 
-    void render(std::vector<Card>& playercards, std::vector<Card>& computercards, std::vector<Card>& tablecards, Card& trump) {
-        float startX = (WINDOW_WIDTH - playercards.size() * CARD_WIDTH) / 2.0f;
-        float playerY = 50.0f;
-        for (int i = 0; i < playercards.size(); ++i) {
-            playercards[i].position = glm::vec2(
-                startX + i * CARD_WIDTH,
-                playerY
-            );
-            playercards[i].isFaceUp = true;
-        }
-
-        startX = (WINDOW_WIDTH - computercards.size() * CARD_WIDTH) / 2.0f;
-        float computerY = WINDOW_HEIGHT - 50.0f - CARD_HEIGHT;
-        for (int i = 0; i < computercards.size(); ++i) {
-            computercards[i].position = glm::vec2(
-                startX + i * CARD_WIDTH,
-                computerY
-            );
-            computercards[i].isFaceUp = false;
-        }
-
-        float tableStartX = (WINDOW_WIDTH - 4 * CARD_WIDTH) / 2.0f;
-        float tableY = WINDOW_HEIGHT / 2.0f - CARD_HEIGHT / 2.0f;
-
-        for (int i = 0; i < tablecards.size() && i < 8; ++i) {
-            int row = i / 4;
-            int col = i % 4;
-            tablecards[i].position = glm::vec2(
-                tableStartX + col * CARD_WIDTH,
-                tableY - row * (CARD_HEIGHT + 10)
-            );
-            tablecards[i].isFaceUp = true;
-        }
-
-        if (trump.rank != Card::JOKER_RANK) {
-            trump.position = glm::vec2(
-                WINDOW_WIDTH - CARD_WIDTH - 20,
-                WINDOW_HEIGHT / 2 - CARD_HEIGHT / 2
-            );
-            trump.isFaceUp = true;
-        }
+    bool uploadAssets(const CardAtlas& cardAtlas, const DecodedImage& background) {
+        return renderer.uploadAssets(cardAtlas, background);
+    }
 
+    void render(const TableLayout& layout, int liftedCard) {
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
+        renderer.resetStats();
 
-        renderer.renderBackground("C:/textures/table.jpg");
+        renderer.renderBackground();
 
-        renderer.renderCards(computercards, projectionMatrix);
-        renderer.renderCards(tablecards, projectionMatrix);
-        renderer.renderCards(playercards, projectionMatrix);
+        renderer.queueLayout(layout, liftedCard);
+        renderer.renderCards(projectionMatrix);
+    }
 
-        if (trump.rank != Card::JOKER_RANK) {
-            renderer.renderCard(trump, projectionMatrix);
-        }
+    // Frame-time graph of the last Profiler::FRAME_HISTORY frames (green up
+    // to 60 fps, red above; the white line is 16.7 ms) with the AI pool's
+    // utilization as a bar underneath.
+    void renderProfilerOverlay(const Profiler& profiler, float poolUtilization) {
+        const float left = 10.0f;
+        const float top = WINDOW_HEIGHT - 10.0f;
+        const float barWidth = 2.0f;
+        const float graphHeight = 100.0f;
+        const float pixelsPerMs = graphHeight / 33.3f;
+        const float graphWidth = Profiler::FRAME_HISTORY * barWidth;
+        const float graphBottom = top - graphHeight;
+
+        renderer.queueOverlayRect(left - 4, graphBottom - 24, left + graphWidth + 4, top + 4, 0.0f, 0.0f, 0.0f, 0.6f);
+        for (int i = 0; i < Profiler::FRAME_HISTORY; ++i) {
+            float ms = profiler.getFrameTime(i);
+            float height = std::min(ms * pixelsPerMs, graphHeight);
+            float x = left + graphWidth - (i + 1) * barWidth;
+            bool slow = ms > 1000.0f * FRAME_INTERVAL;
+            renderer.queueOverlayRect(x, graphBottom, x + barWidth, graphBottom + height,
+                slow ? 0.9f : 0.2f, slow ? 0.2f : 0.9f, 0.2f, 0.9f);
+        }
+        float budget = graphBottom + 1000.0f * static_cast<float>(FRAME_INTERVAL) * pixelsPerMs;
+        renderer.queueOverlayRect(left, budget, left + graphWidth, budget + 1.0f, 1.0f, 1.0f, 1.0f, 0.8f);
+
+        float utilization = std::min(std::max(poolUtilization, 0.0f), 1.0f);
+        renderer.queueOverlayRect(left, graphBottom - 18, left + graphWidth, graphBottom - 6, 0.3f, 0.3f, 0.3f, 0.9f);
+        renderer.queueOverlayRect(left, graphBottom - 18, left + graphWidth * utilization, graphBottom - 6,
+            0.2f, 0.5f, 1.0f, 0.9f);
+
+        renderer.renderOverlay(projectionMatrix);
     }
+
+    RenderStats getRenderStats() const { return renderer.getStats(); }
 };
 
 
 class Game {
 private:
     GLFWwindow* window;
+    AssetPack assetPack;
     GameTable gameTable;
     GameLogic gameLogic;
     Renderer renderer;
     AudioManager audioManager;
     MouseManager mouseManager;
     GameState currentState;
+    GameLog gameLog;
+    TableLayout layout;
+    HitGrid hitGrid;
+    std::string assetPath;
+    std::string assetRoot;
+    CardAtlas cardAtlas;
+    DecodedImage tableImage;
+    DecodedAudio effectClips[SOUND_EFFECT_COUNT];
+    std::unique_ptr<AssetLoader> assetLoader;
+    int shownLoadProgress;
+    bool needsRedraw;
+    bool frameDrawn;
+    unsigned int drawnRevision;
+    bool compressedTextures;
+    bool showProfiler;
+    float poolUtilization;
+    uint64_t poolBusySample;
+    uint64_t poolSampleTime;
 
 public:
-    Game() : window(nullptr), currentState(GameState::START_GAME) {}
+    // assetPath is an asset pack, or a directory of loose asset files.
+    explicit Game(const std::string& assetPath)
+        : window(nullptr), currentState(GameState::LOADING), layout(WINDOW_WIDTH, WINDOW_HEIGHT, CARD_WIDTH, CARD_HEIGHT),
+        hitGrid(WINDOW_WIDTH, WINDOW_HEIGHT),
+        assetPath(assetPath), shownLoadProgress(-1),
+        needsRedraw(true), frameDrawn(false), drawnRevision(0), compressedTextures(true),
+        showProfiler(false), poolUtilization(0.0f), poolBusySample(0), poolSampleTime(0) {}
 
     bool initialize() {
-        audioManager.playAudio(audioManager.loadAudio("C:/textures/Deep_Cover.mp3"));
+        AIWeights weights;
+        if (weights.load(AI_WEIGHTS_PATH)) {
+            std::cout << "Using tuned AI weights from " << AI_WEIGHTS_PATH << std::endl;
+            gameLogic.setAIWeights(weights);
+        }
+        openAssets();
+        if (assetPack.isOpen()) {
+            audioManager.playMusic(assetPack.find(MUSIC_TRACK), true);
+        }
+        else {
+            audioManager.playMusic(assetRoot + MUSIC_TRACK, true);
+        }
+        startLoading();
         if (!glfwInit()) return false;
 
         window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Card Game", nullptr, nullptr);
@@ -1061,20 +745,84 @@ public:
                 game->handleMouseClick(xpos, ypos);
             }
             });
+        glfwSetCursorPosCallback(window, [](GLFWwindow* w, double xpos, double ypos) {
+            static_cast<Game*>(glfwGetWindowUserPointer(w))->handleMouseMove(xpos, ypos);
+            });
+        glfwSetWindowRefreshCallback(window, [](GLFWwindow* w) {
+            static_cast<Game*>(glfwGetWindowUserPointer(w))->needsRedraw = true;
+            });
+#ifdef CARDGAME_PROFILING
+        Profiler::instance().setThreadName("Main");
+        glfwSetKeyCallback(window, [](GLFWwindow* w, int key, int scancode, int action, int mods) {
+            if (action == GLFW_PRESS) {
+                static_cast<Game*>(glfwGetWindowUserPointer(w))->handleKey(key);
+            }
+            });
+#endif
 
         return true;
     }
 
     void run() {
+        double lastStatsTime = glfwGetTime();
+
         while (!glfwWindowShouldClose(window)) {
+#ifdef CARDGAME_PROFILING
+            uint64_t frameStart = Profiler::now();
+#endif
             update();
 
-            glfwSwapBuffers(window);
-            glfwPollEvents();
+            if (frameDrawn) {
+                {
+                    PROFILE_SCOPE("Swap");
+                    glfwSwapBuffers(window);
+                }
+                frameDrawn = false;
+#ifdef CARDGAME_PROFILING
+                Profiler::instance().endFrame(frameStart);
+#endif
+            }
+
+            double timeout = eventTimeout();
+            if (timeout > 0.0) {
+                glfwWaitEventsTimeout(timeout);
+            }
+            else {
+                glfwPollEvents();
+            }
+
+            if (glfwGetTime() - lastStatsTime >= 1.0) {
+                showRenderStats();
+                lastStatsTime = glfwGetTime();
+            }
+        }
+
+        if (!gameLog.actions.empty()) {
+            GameLog::save(GAME_LOG_PATH, std::vector<GameLog>(1, gameLog));
         }
+#ifdef CARDGAME_PROFILING
+        Profiler::instance().dumpChromeTrace(PROFILE_TRACE_PATH);
+#endif
     }
 
 private:
+    // How long the loop may sleep waiting for events: not at all while the
+    // computer has a move to make, one fixed tick while the loading screen
+    // animates, and otherwise until input arrives.
+    double eventTimeout() const {
+        switch (currentState) {
+        case GameState::LOADING:
+            return FRAME_INTERVAL;
+        case GameState::PLAYER_TURN_ATTACK:
+        case GameState::PLAYER_TURN_DEFEND:
+        case GameState::GAME_OVER:
+            if (showProfiler) return FRAME_INTERVAL;
+            return needsRedraw ? 0.0 : IDLE_TIMEOUT;
+        default:
+            return 0.0;
+        }
+    }
+
     void update() {
         switch (currentState) {
         case GameState::START_GAME:
@@ -1095,71 +843,254 @@ private:
         case GameState::GAME_OVER:
             updateGameOver();
             break;
+        case GameState::LOADING:
+            updateLoading();
+            break;
+        }
+    }
+
+    // Maps the asset pack, or falls back to loose files: assetPath itself if
+    // it is a directory, otherwise the textures/ directory beside it. The
+    // card atlas cache is written to assetRoot either way.
+    void openAssets() {
+        std::error_code error;
+        std::filesystem::path path(assetPath);
+        if (std::filesystem::is_directory(path, error)) {
+            assetRoot = (path / "").generic_string();
+            return;
+        }
+
+        assetRoot = (path.parent_path() / "").generic_string();
+        if (assetPack.open(assetPath)) {
+            std::cout << "Using asset pack " << assetPath << " (" << assetPack.getCount() << " files)" << std::endl;
+        }
+        else {
+            assetRoot += LOOSE_ASSET_DIR;
+            std::cout << "No asset pack at " << assetPath << "; loading loose files from " << assetRoot << std::endl;
+        }
+    }
+
+    // Decodes the card images, the table and the sound effects on worker
+    // threads; the window opens and keeps drawing the loading screen meanwhile.
+    void startLoading() {
+        unsigned int numThreads = std::thread::hardware_concurrency();
+        assetLoader.reset(new AssetLoader(numThreads > 0 ? static_cast<int>(numThreads) : 2, assetRoot,
+            assetPack.isOpen() ? &assetPack : nullptr));
+        assetLoader->loadCardAtlas(assetRoot + "cards.atlas", cardAtlas, compressedTextures);
+        assetLoader->loadImage("table.jpg", tableImage);
+        for (int i = 0; i < SOUND_EFFECT_COUNT; ++i) {
+            assetLoader->loadAudio(SOUND_EFFECT_FILES[i], effectClips[i]);
+        }
+        shownLoadProgress = -1;
+    }
+
+    void updateLoading() {
+        int completed = assetLoader->getCompleted();
+        if (completed != shownLoadProgress || needsRedraw) {
+            glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            frameDrawn = true;
+            needsRedraw = false;
+
+            std::string title = "Card Game | loading " + std::to_string(completed) + "/" +
+                std::to_string(assetLoader->getTotal());
+            glfwSetWindowTitle(window, title.c_str());
+            shownLoadProgress = completed;
+        }
+        if (!assetLoader->isFinished()) return;
+
+        assetLoader.reset();
+        needsRedraw = true;
+        bool uploaded;
+        {
+            PROFILE_SCOPE("Texture upload");
+            uploaded = gameTable.uploadAssets(cardAtlas, tableImage);
+        }
+        if (!uploaded && compressedTextures) {
+            // No S3TC, or a broken cards.ktx: load again from the card images.
+            std::cout << "Falling back to uncompressed card textures" << std::endl;
+            compressedTextures = false;
+            cardAtlas.releasePixels();
+            tableImage.free();
+            startLoading();
+            return;
+        }
+        cardAtlas.releasePixels();
+        tableImage.free();
+        for (int i = 0; i < SOUND_EFFECT_COUNT; ++i) {
+            audioManager.loadEffect(i, effectClips[i]);
+            effectClips[i] = DecodedAudio();
+        }
+
+        glfwSetWindowTitle(window, "Card Game");
+        currentState = GameState::START_GAME;
+    }
+
+    // Leaves the loading progress in the title until the game starts.
+    void showRenderStats() {
+        if (currentState == GameState::LOADING) return;
+        RenderStats stats = gameTable.getRenderStats();
+        std::string title = "Card Game | draw calls: " + std::to_string(stats.drawCalls) +
+            ", state changes: " + std::to_string(stats.stateChanges) +
+            " (skipped " + std::to_string(stats.skippedStateChanges) + ")" +
+            ", cards: " + std::to_string(stats.cards);
+        if (showProfiler) {
+            title += ", frame: " + std::to_string(Profiler::instance().getFrameTime(0)) + " ms" +
+                ", AI pool: " + std::to_string(static_cast<int>(poolUtilization * 100.0f)) + "%";
+        }
+        glfwSetWindowTitle(window, title.c_str());
+    }
+
+    // F3 toggles the profiler overlay, F4 writes the Chrome trace.
+    void handleKey(int key) {
+        if (key == GLFW_KEY_F3) {
+            showProfiler = !showProfiler;
+            needsRedraw = true;
+        }
+        else if (key == GLFW_KEY_F4) {
+            if (Profiler::instance().dumpChromeTrace(PROFILE_TRACE_PATH)) {
+                std::cout << "Profile written to " << PROFILE_TRACE_PATH << std::endl;
+            }
+        }
+    }
+
+    // Share of the AI workers' time spent running tasks since the last sample.
+    void samplePoolUtilization() {
+        const AIWorkerPool* pool = gameLogic.getAIPool();
+        uint64_t now = Profiler::now();
+        uint64_t busy = pool ? pool->getBusyTime() : 0;
+        if (pool && poolSampleTime != 0 && now - poolSampleTime >= 250000000ull) {
+            poolUtilization = static_cast<float>(busy - poolBusySample) /
+                (static_cast<float>(now - poolSampleTime) * pool->size());
+        }
+        if (poolSampleTime == 0 || now - poolSampleTime >= 250000000ull) {
+            poolBusySample = busy;
+            poolSampleTime = now;
+        }
+    }
+
+    // Redraws only when the game state changed or something (input, a window
+    // refresh) asked for a new frame.
+    void renderTable() {
+        if (showProfiler) needsRedraw = true;
+        if (!needsRedraw && gameLogic.getRevision() == drawnRevision) return;
+
+        {
+            PROFILE_SCOPE("Layout");
+            if (layout.update(gameLogic.getPlayerHand(), gameLogic.getComputerHand(), gameLogic.getTable(),
+                gameLogic.getTableSize(), gameLogic.getTrumpId())) {
+                hitGrid.build(layout);
+            }
+        }
+
+        int liftedCard = -1;
+        const HitResult& hovered = mouseManager.getHovered();
+        if (hovered.zone == TableLayout::ZONE_PLAYER_HAND && isPlayerTurn()) {
+            liftedCard = layout.zoneBegin(TableLayout::ZONE_PLAYER_HAND) + hovered.index;
+        }
+        hitGrid.setLifted(liftedCard, HOVER_LIFT);
+        {
+            PROFILE_SCOPE("Draw");
+            gameTable.render(layout, liftedCard);
+#ifdef CARDGAME_PROFILING
+            if (showProfiler) {
+                samplePoolUtilization();
+                gameTable.renderProfilerOverlay(Profiler::instance(), poolUtilization);
+            }
+#endif
+        }
+
+        drawnRevision = gameLogic.getRevision();
+        needsRedraw = false;
+        frameDrawn = true;
+    }
+
+    bool isPlayerTurn() const {
+        return currentState == GameState::PLAYER_TURN_ATTACK || currentState == GameState::PLAYER_TURN_DEFEND;
+    }
+
+    void handleMouseMove(double xpos, double ypos) {
+        if (mouseManager.onMouseMove(xpos, ypos, hitGrid) && isPlayerTurn()) {
+            needsRedraw = true;
         }
     }
 
     void handleMouseClick(double xpos, double ypos) {
+        needsRedraw = true;
         switch (currentState) {
         case GameState::PLAYER_TURN_ATTACK:
-            mouseManager.onMouseClick(xpos, ypos, gameLogic.getPlayerCards());
+            mouseManager.onMouseClick(xpos, ypos, hitGrid, layout);
             break;
         case GameState::PLAYER_TURN_DEFEND:
-            mouseManager.onMouseClick(xpos, ypos, gameLogic.getPlayerCards());
+            mouseManager.onMouseClick(xpos, ypos, hitGrid, layout);
             break;
         }
     }
 
     void updatePlayerAttack() {
-        gameTable.render(gameLogic.getPlayerCards(), gameLogic.getComputerCards(), gameLogic.getTableCards(), gameLogic.getTrumpCard());
+        renderTable();
         int selectedCard = mouseManager.getSelectedCardIndex();
         if (selectedCard >= 0) {
+            int cardId = cardAtIndex(gameLogic.getPlayerHand(), selectedCard);
             if (gameLogic.playerAttack(selectedCard)) {
+                gameLog.record(GameLog::encode(GameLog::ATTACK, cardId));
                 std::cout << "Player attacks with card #" << selectedCard << std::endl;
+                audioManager.playEffect(SOUND_CARD_PLAY, 1);
                 currentState = GameState::COMPUTER_TURN_DEFEND;
             }
             mouseManager.clearSelection();
         }
         else if (selectedCard == -2) {
+            gameLog.record(GameLog::encode(GameLog::END_MOVE));
             gameLogic.freetablecards();
-            gameLogic.dealCards(gameLogic.getDeck());
+            gameLogic.dealCards();
             currentState = GameState::COMPUTER_TURN_ATTACK;
             std::cout << "Player end move" << std::endl;
         }
     }
 
     void updatePlayerDefend() {
-        gameTable.render(gameLogic.getPlayerCards(), gameLogic.getComputerCards(), gameLogic.getTableCards(), gameLogic.getTrumpCard());
+        renderTable();
         int selectedCard = mouseManager.getSelectedCardIndex();
         if (selectedCard >= 0) {
-            auto& tableCards = gameLogic.getTableCards();
-            if (!tableCards.empty()) {
-                int attackCardIndex = static_cast<int>(tableCards.size()) - 1;
+            if (gameLogic.getTableSize() > 0) {
+                int attackCardIndex = gameLogic.getTableSize() - 1;
+                int cardId = cardAtIndex(gameLogic.getPlayerHand(), selectedCard);
                 if (gameLogic.playerDefend(attackCardIndex, selectedCard)) {
+                    gameLog.record(GameLog::encode(GameLog::DEFEND, cardId));
                     std::cout << "Player defends with card #" << selectedCard << std::endl;
+                    audioManager.playEffect(SOUND_CARD_BEAT, 1);
                     currentState = GameState::COMPUTER_TURN_ATTACK;
                 }
             }
             mouseManager.clearSelection();
         }
         else if (selectedCard == -3) {
+            gameLog.record(GameLog::encode(GameLog::TAKE));
             gameLogic.playergettablecards();
-            gameLogic.dealCards(gameLogic.getDeck());
+            audioManager.playEffect(SOUND_TAKE_CARDS, 2);
+            gameLogic.dealCards();
             std::cout << "Player end move" << std::endl;
             currentState = GameState::COMPUTER_TURN_ATTACK;
         }
     }
 
     void updateComputerAttack() {
-        int cardIndex = gameLogic.calculateAIMove(true, 4);
-        if (cardIndex != -1) {
-            Card attackingCard = gameLogic.getComputerCards()[cardIndex];
-            gameLogic.getTableCards().push_back(attackingCard);
-            gameLogic.getComputerCards().erase(gameLogic.getComputerCards().begin() + cardIndex);
+        int cardIndex;
+        {
+            PROFILE_SCOPE("AI attack");
+            cardIndex = gameLogic.calculateAIMove(true, 4);
+        }
+        int cardId = cardIndex < 0 ? -1 : cardAtIndex(gameLogic.getComputerHand(), cardIndex);
+        if (gameLogic.computerAttack(cardIndex)) {
+            gameLog.record(GameLog::encode(GameLog::ATTACK, cardId));
             std::cout << "Computer attacks with card #" << cardIndex << std::endl;
+            audioManager.playEffect(SOUND_CARD_PLAY, 1);
             currentState = GameState::PLAYER_TURN_DEFEND;
         }
         else {
-            gameLogic.dealCards(gameLogic.getDeck());
+            gameLog.record(GameLog::encode(GameLog::END_MOVE));
+            gameLogic.dealCards();
             gameLogic.freetablecards();
             currentState = GameState::PLAYER_TURN_ATTACK;
             std::cout << "Computer end move" << std::endl;
@@ -1167,21 +1098,23 @@ private:
     }
 
     void updateComputerDefend() {
-        int cardIndex = gameLogic.calculateAIMove(false, 4); 
-
-        if (cardIndex != -1) {
-            Card& attackCard = gameLogic.getTableCards().back();
-            Card defendCard = gameLogic.getComputerCards()[cardIndex];
-
-            attackCard.isFaceUp = false;
-            gameLogic.getTableCards().push_back(defendCard);
-            gameLogic.getComputerCards().erase(gameLogic.getComputerCards().begin() + cardIndex);
+        int cardIndex;
+        {
+            PROFILE_SCOPE("AI defend");
+            cardIndex = gameLogic.calculateAIMove(false, 4);
+        }
+        int cardId = cardIndex < 0 ? -1 : cardAtIndex(gameLogic.getComputerHand(), cardIndex);
 
+        if (gameLogic.computerDefend(cardIndex)) {
+            gameLog.record(GameLog::encode(GameLog::DEFEND, cardId));
             std::cout << "Computer defends with card #" << cardIndex << std::endl;
+            audioManager.playEffect(SOUND_CARD_BEAT, 1);
         }
         else {
+            gameLog.record(GameLog::encode(GameLog::TAKE));
             gameLogic.computergettablecards();
-            gameLogic.dealCards(gameLogic.getDeck());
+            audioManager.playEffect(SOUND_TAKE_CARDS, 2);
+            gameLogic.dealCards();
             std::cout << "Computer end move" << std::endl;
         }
 
@@ -1194,23 +1127,35 @@ private:
         }
     }
 
+    // Every game is dealt from a fresh seed and logged, so it can be replayed
+    // with `selfplay --replay last_game.dlog`.
     void updatestartgame() {
-        gameLogic.createFullDeck();
-        gameLogic.shuffleDeck(gameLogic.getDeck());
-        gameLogic.firstdealCards(gameLogic.getDeck());
-        gameTable.render(gameLogic.getPlayerCards(), gameLogic.getComputerCards(), gameLogic.getTableCards(), gameLogic.getTrumpCard());
+        std::random_device device;
+        gameLog.start((static_cast<uint64_t>(device()) << 32) | device());
+        GameLog::deal(gameLogic, gameLog.seed);
+        renderTable();
         currentState = GameState::PLAYER_TURN_ATTACK;
     }
 
     void restartGame() {
         gameTable = GameTable();
         gameTable.init();
-        currentState = GameState::PLAYER_TURN_ATTACK;
+        startLoading();
+        currentState = GameState::LOADING;
     }
 };
 
-int main() {
-    Game game;
+// The directory holding the executable, so assets are found from any working
+// directory.
+std::string executableDirectory(const char* argv0) {
+    std::error_code error;
+    std::filesystem::path exe = std::filesystem::read_symlink("/proc/self/exe", error);
+    if (error) exe = std::filesystem::absolute(argv0, error);
+    return (exe.parent_path() / "").generic_string();
+}
+
+int main(int argc, char** argv) {
+    Game game(argc > 1 ? argv[1] : executableDirectory(argv[0]) + ASSET_PACK_NAME);
 
     if (!game.initialize()) {
         std::cerr << "Failed to initialize game!" << std::endl;
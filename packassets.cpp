@@ -0,0 +1,25 @@
+#include "AssetPack.h"
+#include <iostream>
+#include <vector>
+#include <string>
+
+// Bundles directories of assets into the single pack the game maps at startup.
+// usage: packassets <output pack> <asset dir>...
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: packassets <output pack> <asset dir>..." << std::endl;
+        return -1;
+    }
+
+    std::vector<std::string> dirs(argv + 2, argv + argc);
+    if (!AssetPack::write(dirs, argv[1])) {
+        std::cerr << "Failed to write asset pack: " << argv[1] << std::endl;
+        return -1;
+    }
+
+    AssetPack pack;
+    if (!pack.open(argv[1])) return -1;
+    std::cout << "packed " << pack.getCount() << " files into " << argv[1] << std::endl;
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include "SelfPlay.h"
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <random>
+
+// Headless AI-vs-AI runner: no GL, AL or GLFW needed.
+// usage: selfplay [--games N] [--workers N] [--player-threads N] [--computer-threads N] [--max-actions N]
+//                 [--player-ai heuristic|ismcts] [--computer-ai heuristic|ismcts]
+//                 [--ismcts-iterations N] [--ismcts-ms N]
+//                 [--player-endgame 0|1] [--computer-endgame 0|1]   endgame solver, off by default
+//                 [--latency 1]   per-move AI latency, simple path vs worker pool
+//                 [--seed N]      game i is dealt from seed N + i (random by default)
+//                 [--record FILE] write every game as a binary GameLog batch
+//                 [--replay FILE] replay a recorded batch through the rules, no AI
+//                 [--player-weights FILE] [--computer-weights FILE]   heuristic weights, e.g. from tune
+
+int main(int argc, char** argv) {
+    SelfPlayConfig config;
+    bool measureLatency = false;
+    std::string recordPath;
+    std::string replayPath;
+    config.workers = std::max(1u, std::thread::hardware_concurrency());
+    std::random_device device;
+    config.seed = (static_cast<uint64_t>(device()) << 32) | device();
+
+    for (int i = 1; i < argc; i += 2) {
+        std::string arg = argv[i];
+        if (i + 1 == argc) {
+            std::cerr << "Missing value for option: " << arg << std::endl;
+            return -1;
+        }
+        std::string text = argv[i + 1];
+        long long value = std::atoll(argv[i + 1]);
+        AIMode mode = text == "ismcts" ? AIMode::ISMCTS : AIMode::HEURISTIC;
+
+        if (arg == "--games") config.games = value;
+        else if (arg == "--workers") config.workers = static_cast<int>(value);
+        else if (arg == "--player-threads") config.playerAIThreads = static_cast<int>(value);
+        else if (arg == "--computer-threads") config.computerAIThreads = static_cast<int>(value);
+        else if (arg == "--max-actions") config.maxActions = static_cast<int>(value);
+        else if (arg == "--player-ai") config.playerAIMode = mode;
+        else if (arg == "--computer-ai") config.computerAIMode = mode;
+        else if (arg == "--ismcts-iterations") config.ismcts.iterations = static_cast<int>(value);
+        else if (arg == "--ismcts-ms") config.ismcts.timeBudgetMs = std::atof(argv[i + 1]);
+        else if (arg == "--player-endgame") config.playerEndgameSolver = value != 0;
+        else if (arg == "--computer-endgame") config.computerEndgameSolver = value != 0;
+        else if (arg == "--latency") measureLatency = value != 0;
+        else if (arg == "--seed") config.seed = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (arg == "--record") recordPath = text;
+        else if (arg == "--replay") replayPath = text;
+        else if (arg == "--player-weights" || arg == "--computer-weights") {
+            AIWeights& weights = arg == "--player-weights" ? config.playerWeights : config.computerWeights;
+            if (!weights.load(text)) {
+                std::cerr << "Failed to read AI weights: " << text << std::endl;
+                return -1;
+            }
+        }
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return -1;
+        }
+    }
+
+    if (!replayPath.empty()) {
+        std::vector<GameLog> logs;
+        if (!GameLog::load(replayPath, logs)) {
+            std::cerr << "Failed to read game log: " << replayPath << std::endl;
+            return -1;
+        }
+
+        SelfPlayStats stats;
+        long long mismatches = SelfPlayEngine::replay(logs, stats);
+        std::cout << "replayed:       " << stats.games << std::endl;
+        std::cout << "mismatches:     " << mismatches << std::endl;
+        std::cout << "seconds:        " << stats.seconds << std::endl;
+        std::cout << "games/sec:      " << stats.gamesPerSecond() << std::endl;
+        std::cout << "player wins:    " << stats.playerWins << std::endl;
+        std::cout << "computer wins:  " << stats.computerWins << std::endl;
+        return mismatches == 0 ? 0 : 1;
+    }
+
+    config.record = !recordPath.empty();
+    SelfPlayEngine engine(config);
+
+    if (measureLatency) {
+        MoveLatencyStats latency = engine.measureMoveLatency();
+        std::cout << "moves:                " << latency.moves << std::endl;
+        std::cout << "simple us/move:       " << latency.simpleMicros() << std::endl;
+        std::cout << "multi-thread us/move: " << latency.multiThreadMicros() << std::endl;
+        return 0;
+    }
+
+    SelfPlayStats stats = engine.run();
+    if (config.record && !GameLog::save(recordPath, engine.getLogs())) {
+        std::cerr << "Failed to write game log: " << recordPath << std::endl;
+    }
+
+    double games = stats.games > 0 ? static_cast<double>(stats.games) : 1.0;
+    std::cout << "seed:           " << config.seed << std::endl;
+    std::cout << "games:          " << stats.games << std::endl;
+    std::cout << "seconds:        " << stats.seconds << std::endl;
+    std::cout << "games/sec:      " << stats.gamesPerSecond() << std::endl;
+    std::cout << "player wins:    " << stats.playerWins << " (" << 100.0 * stats.playerWins / games << "%)" << std::endl;
+    std::cout << "computer wins:  " << stats.computerWins << " (" << 100.0 * stats.computerWins / games << "%)" << std::endl;
+    std::cout << "draws:          " << stats.draws << std::endl;
+    std::cout << "aborted:        " << stats.aborted << std::endl;
+    std::cout << "actions/game:   " << stats.actions / games << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,41 @@
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "CardAtlas.h"
+#include "TextureCompressor.h"
+#include <iostream>
+#include <string>
+
+// Builds the card atlas from the card images, box-filters its mip chain and
+// block-compresses every level into cards.ktx, which the game uploads as is.
+// Runs entirely on the CPU.
+// usage: texconvert <texture dir> <output dir>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "usage: texconvert <texture dir> <output dir>" << std::endl;
+        return -1;
+    }
+    std::string textureDir = std::string(argv[1]) + "/";
+    std::string outPath = std::string(argv[2]) + "/" + CardAtlas::COMPRESSED_FILE;
+
+    CardAtlas atlas;
+    if (!atlas.build(textureDir)) {
+        std::cerr << "Missing card images in " << textureDir << std::endl;
+        return -1;
+    }
+
+    RgbaImage image;
+    image.width = atlas.getWidth();
+    image.height = atlas.getHeight();
+    image.pixels.assign(atlas.getPixels(), atlas.getPixels() + static_cast<size_t>(image.width) * image.height * 4);
+    CompressedTexture texture = TextureCompressor::compress(image);
+
+    if (!texture.save(outPath)) {
+        std::cerr << "Failed to write " << outPath << std::endl;
+        return -1;
+    }
+    std::cout << "wrote " << outPath << ": " << image.width << "x" << image.height << ", "
+        << texture.levels.size() << " levels, " << texture.storage.size() << " bytes (RGBA with mipmaps: "
+        << image.pixels.size() * 4 / 3 << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "WeightTuner.h"
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <random>
+
+// Tunes the heuristic AI's weights by self-play on every core.
+// usage: tune [--iterations N] [--games N] [--verify-games N] [--workers N] [--seed N]
+//             [--learning-rate X] [--perturbation X]
+//             [--start FILE]  weights to start from (the built-in defaults otherwise)
+//             [--out FILE]    where to write the result (ai_weights.txt by default, which the game loads)
+
+int main(int argc, char** argv) {
+    TunerConfig config;
+    AIWeights start;
+    std::string outPath = "ai_weights.txt";
+    config.workers = std::max(1u, std::thread::hardware_concurrency());
+    std::random_device device;
+    config.seed = (static_cast<uint64_t>(device()) << 32) | device();
+
+    for (int i = 1; i < argc; i += 2) {
+        std::string arg = argv[i];
+        if (i + 1 == argc) {
+            std::cerr << "Missing value for option: " << arg << std::endl;
+            return -1;
+        }
+        std::string text = argv[i + 1];
+        long long value = std::atoll(argv[i + 1]);
+
+        if (arg == "--iterations") config.iterations = static_cast<int>(value);
+        else if (arg == "--games") config.games = value;
+        else if (arg == "--verify-games") config.verifyGames = value;
+        else if (arg == "--workers") config.workers = static_cast<int>(value);
+        else if (arg == "--seed") config.seed = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (arg == "--learning-rate") config.learningRate = std::atof(argv[i + 1]);
+        else if (arg == "--perturbation") config.perturbation = std::atof(argv[i + 1]);
+        else if (arg == "--out") outPath = text;
+        else if (arg == "--start") {
+            if (!start.load(text)) {
+                std::cerr << "Failed to read AI weights: " << text << std::endl;
+                return -1;
+            }
+        }
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return -1;
+        }
+    }
+
+    std::cout << "seed: " << config.seed << ", workers: " << config.workers << std::endl;
+    WeightTuner tuner(config, start);
+    AIWeights best = tuner.run();
+
+    std::cout << "tuned vs start: " << tuner.getVerifiedScore() << " over " << 2 * config.verifyGames << " games" << std::endl;
+    if (tuner.getVerifiedScore() <= 0.5) {
+        std::cout << "no improvement; keeping the start weights" << std::endl;
+    }
+    for (int i = 0; i < AIWeights::COUNT; ++i) {
+        std::cout << AIWeights::name(i) << " " << best.values[i] << std::endl;
+    }
+
+    if (!best.save(outPath)) {
+        std::cerr << "Failed to write AI weights: " << outPath << std::endl;
+        return -1;
+    }
+    std::cout << "written to " << outPath << std::endl;
+    return 0;
+}